@@ -16,11 +16,15 @@ namespace Algorithm {
         SquareMatrix(int n)
             : m_n(n)
             , m_data(n * n) {}
+        // Entries are left uninitialized, for matrices filled right after.
+        SquareMatrix(int n, TinySTL::default_init_t)
+            : m_n(n)
+            , m_data(n * n, TinySTL::default_init) {}
         ~SquareMatrix() = default;
 
     public:
         SquareMatrix SubMatrix(int row, int col, int n) const {
-            SquareMatrix ret(n);
+            SquareMatrix ret(n, TinySTL::default_init);
             for (int i = 0; i < n; ++i) {
                 for (int j = 0; j < n; ++j) {
                     ret(i, j) = this->operator()(row + i, col + j);
@@ -2,6 +2,8 @@
 #define _TINYSTL_ALGORITHM_HPP_
 
 #include <cstdlib>
+#include <cstring>
+#include <utility>
 #include <stl_heap.hpp>
 #include <stl_iterator.hpp>
 #include <stl_pair.hpp>
@@ -75,15 +77,42 @@ namespace TinySTL {
 
     //! ----- Memory Operations ------ !//
 
+    template <typename ForwardIterator, typename T>
+    void fill(ForwardIterator first, ForwardIterator last, const T& value);
+
     //! O(n)
-    // Fill the same `value` in [`first`, `last`).
     template <typename ForwardIterator, typename T>
-    void fill(ForwardIterator first, ForwardIterator last, const T& value) {
+    void __fill(ForwardIterator first, ForwardIterator last, const T& value, __false_type) {
         for (; first != last; ++first) {
             *first = value;
         }
     }
 
+    // Segmented iterator version, fill segment by segment.
+    template <typename ForwardIterator, typename T>
+    void __fill(ForwardIterator first, ForwardIterator last, const T& value, __true_type) {
+        using traits = __segmented_iterator_traits<ForwardIterator>;
+        auto first_segment = traits::segment(first);
+        auto last_segment  = traits::segment(last);
+        if (first_segment == last_segment) {
+            TinySTL::fill(traits::local(first), traits::local(last), value);
+            return;
+        }
+        TinySTL::fill(traits::local(first), traits::end(first_segment), value);
+        for (++first_segment; first_segment != last_segment; ++first_segment) {
+            TinySTL::fill(traits::begin(first_segment), traits::end(first_segment), value);
+        }
+        TinySTL::fill(traits::begin(last_segment), traits::local(last), value);
+    }
+
+    //! O(n)
+    // Fill the same `value` in [`first`, `last`).
+    template <typename ForwardIterator, typename T>
+    void fill(ForwardIterator first, ForwardIterator last, const T& value) {
+        using segmented = typename __segmented_iterator_traits<ForwardIterator>::is_segmented;
+        __fill(first, last, value, segmented());
+    }
+
     //! O(n)
     // Fill `n` same `value` start from `first`.
     template <typename OutputIterator, typename Size, typename T>
@@ -132,6 +161,9 @@ namespace TinySTL {
     // If has_trivial_assignment_operator.
     template <typename T>
     inline T* __copy_trivial(const T* first, const T* last, T* result, __true_type) {
+        if (first == last) {
+            return result;
+        }
         memmove(result, first, sizeof(T) * (last - first));
         return result + (last - first);
     }
@@ -159,11 +191,36 @@ namespace TinySTL {
         }
     };
 
+    template <typename InputIterator, typename OutputIterator>
+    inline OutputIterator copy(InputIterator first, InputIterator last, OutputIterator output);
+
+    template <typename InputIterator, typename OutputIterator>
+    inline OutputIterator __copy_segmented(InputIterator first, InputIterator last, OutputIterator output, __false_type) {
+        return __copy_dispatch<InputIterator, OutputIterator>()(first, last, output);
+    }
+
+    // Segmented iterator version, copy segment by segment, so that each segment can use `memmove`.
+    template <typename InputIterator, typename OutputIterator>
+    OutputIterator __copy_segmented(InputIterator first, InputIterator last, OutputIterator output, __true_type) {
+        using traits = __segmented_iterator_traits<InputIterator>;
+        auto first_segment = traits::segment(first);
+        auto last_segment  = traits::segment(last);
+        if (first_segment == last_segment) {
+            return TinySTL::copy(traits::local(first), traits::local(last), output);
+        }
+        output = TinySTL::copy(traits::local(first), traits::end(first_segment), output);
+        for (++first_segment; first_segment != last_segment; ++first_segment) {
+            output = TinySTL::copy(traits::begin(first_segment), traits::end(first_segment), output);
+        }
+        return TinySTL::copy(traits::begin(last_segment), traits::local(last), output);
+    }
+
     //! O(n)
     // Copy the value in [`first`, `last`) to container start from `output`.
     template <typename InputIterator, typename OutputIterator>
     inline OutputIterator copy(InputIterator first, InputIterator last, OutputIterator output) {
-        return __copy_dispatch<InputIterator, OutputIterator>()(first, last, output);
+        using segmented = typename __segmented_iterator_traits<InputIterator>::is_segmented;
+        return __copy_segmented(first, last, output, segmented());
     }
 
     inline char* copy(const char* first, const char* last, char* result) {
@@ -205,6 +262,9 @@ namespace TinySTL {
     template <typename T>
     T* __copy_backward_trivial(const T* first, const T* last, T* result, __true_type) {
         const ptrdiff_t len = last - first;
+        if (len == 0) {
+            return result;
+        }
         memmove(result - len, first, sizeof(T) * len);
         return result - len;
     }
@@ -237,6 +297,51 @@ namespace TinySTL {
         return __copy_backward_dispatch<BidirectionalIterator1, BidirectionalIterator2>()(first, last, output);
     }
 
+    //! O(n)
+    template <typename InputIterator, typename OutputIterator>
+    inline OutputIterator __move(InputIterator first, InputIterator last, OutputIterator result, __false_type) {
+        for (; first != last; ++first, ++result) {
+            *result = std::move(*first);
+        }
+        return result;
+    }
+
+    // Moving a trivial type is copying it.
+    template <typename InputIterator, typename OutputIterator>
+    inline OutputIterator __move(InputIterator first, InputIterator last, OutputIterator result, __true_type) {
+        return copy(first, last, result);
+    }
+
+    //! O(n)
+    // Move the value in [`first`, `last`) to container start from `output`.
+    template <typename InputIterator, typename OutputIterator>
+    inline OutputIterator move(InputIterator first, InputIterator last, OutputIterator output) {
+        using assign_op = typename __type_traits<typename iterator_traits<InputIterator>::value_type>::has_trivial_assignment_operator;
+        return __move(first, last, output, assign_op());
+    }
+
+    //! O(n)
+    template <typename BidirectionalIterator1, typename BidirectionalIterator2>
+    inline BidirectionalIterator2 __move_backward(BidirectionalIterator1 first, BidirectionalIterator1 last, BidirectionalIterator2 result, __false_type) {
+        while (first != last) {
+            *--result = std::move(*--last);
+        }
+        return result;
+    }
+
+    template <typename BidirectionalIterator1, typename BidirectionalIterator2>
+    inline BidirectionalIterator2 __move_backward(BidirectionalIterator1 first, BidirectionalIterator1 last, BidirectionalIterator2 result, __true_type) {
+        return copy_backward(first, last, result);
+    }
+
+    //! O(n)
+    // Move the value in [`first`, `last`) to container end with `output` (exclusive).
+    template <typename BidirectionalIterator1, typename BidirectionalIterator2>
+    inline BidirectionalIterator2 move_backward(BidirectionalIterator1 first, BidirectionalIterator1 last, BidirectionalIterator2 output) {
+        using assign_op = typename __type_traits<typename iterator_traits<BidirectionalIterator1>::value_type>::has_trivial_assignment_operator;
+        return __move_backward(first, last, output, assign_op());
+    }
+
     //! O(1)
     template <typename T>
     constexpr void swap(T& a, T& b) {
@@ -691,16 +796,51 @@ namespace TinySTL {
 
     //! ----- Generation ------ !//
 
-    //! O(n)
-    // Apply a function to every element of a range.
     template <typename InputIterator, typename UnaryOperator>
-    UnaryOperator for_each(InputIterator first, InputIterator last, UnaryOperator op) {
+    UnaryOperator for_each(InputIterator first, InputIterator last, UnaryOperator op);
+
+    // Apply `op` through a reference, so that the segmented version carries one functor across
+    // all segments. A lambda cannot be assigned back from each segment.
+    template <typename InputIterator, typename UnaryOperator>
+    void __for_each_aux(InputIterator first, InputIterator last, UnaryOperator& op) {
         for (; first != last; ++first) {
             op(*first);
         }
+    }
+
+    //! O(n)
+    template <typename InputIterator, typename UnaryOperator>
+    UnaryOperator __for_each(InputIterator first, InputIterator last, UnaryOperator op, __false_type) {
+        TinySTL::__for_each_aux(first, last, op);
+        return op;
+    }
+
+    // Segmented iterator version, apply segment by segment.
+    template <typename InputIterator, typename UnaryOperator>
+    UnaryOperator __for_each(InputIterator first, InputIterator last, UnaryOperator op, __true_type) {
+        using traits = __segmented_iterator_traits<InputIterator>;
+        auto first_segment = traits::segment(first);
+        auto last_segment  = traits::segment(last);
+        if (first_segment == last_segment) {
+            TinySTL::__for_each_aux(traits::local(first), traits::local(last), op);
+            return op;
+        }
+        TinySTL::__for_each_aux(traits::local(first), traits::end(first_segment), op);
+        for (++first_segment; first_segment != last_segment; ++first_segment) {
+            TinySTL::__for_each_aux(traits::begin(first_segment), traits::end(first_segment), op);
+        }
+        TinySTL::__for_each_aux(traits::begin(last_segment), traits::local(last), op);
         return op;
     }
 
+    //! O(n)
+    // Apply a function to every element of a range.
+    template <typename InputIterator, typename UnaryOperator>
+    UnaryOperator for_each(InputIterator first, InputIterator last, UnaryOperator op) {
+        using segmented = typename __segmented_iterator_traits<InputIterator>::is_segmented;
+        return __for_each(first, last, op, segmented());
+    }
+
     //! O(n)
     // Generate values for a range, using `operator=`.
     template <typename ForwardIterator, typename Generator>
@@ -817,17 +957,49 @@ namespace TinySTL {
         return result;
     }
 
+    template <typename InputIterator, typename T>
+    inline InputIterator find(InputIterator first, InputIterator last, const T& value);
+
     //! O(n)
-    // Find the first element that is equal to `value`.
-    // For RandomAccessIterator, vectorized version can be implemented.
     template <typename InputIterator, typename T>
-    inline InputIterator find(InputIterator first, InputIterator last, const T& value) {
+    inline InputIterator __find(InputIterator first, InputIterator last, const T& value, __false_type) {
         while (first != last && *first != value) {
             ++first;
         }
         return first;
     }
 
+    // Segmented iterator version, search segment by segment.
+    template <typename InputIterator, typename T>
+    InputIterator __find(InputIterator first, InputIterator last, const T& value, __true_type) {
+        using traits = __segmented_iterator_traits<InputIterator>;
+        auto first_segment = traits::segment(first);
+        auto last_segment  = traits::segment(last);
+        if (first_segment == last_segment) {
+            return traits::compose(first_segment, TinySTL::find(traits::local(first), traits::local(last), value));
+        }
+        auto local = TinySTL::find(traits::local(first), traits::end(first_segment), value);
+        if (local != traits::end(first_segment)) {
+            return traits::compose(first_segment, local);
+        }
+        for (++first_segment; first_segment != last_segment; ++first_segment) {
+            local = TinySTL::find(traits::begin(first_segment), traits::end(first_segment), value);
+            if (local != traits::end(first_segment)) {
+                return traits::compose(first_segment, local);
+            }
+        }
+        return traits::compose(last_segment, TinySTL::find(traits::begin(last_segment), traits::local(last), value));
+    }
+
+    //! O(n)
+    // Find the first element that is equal to `value`.
+    // For RandomAccessIterator, vectorized version can be implemented.
+    template <typename InputIterator, typename T>
+    inline InputIterator find(InputIterator first, InputIterator last, const T& value) {
+        using segmented = typename __segmented_iterator_traits<InputIterator>::is_segmented;
+        return __find(first, last, value, segmented());
+    }
+
     //! O(n)
     // Find the first element that satisfy the Predicate.
     // For RandomAccessIterator, vectorized version can be implemented.
@@ -2,10 +2,23 @@
 #define _TINYSTL_ALLOC_HPP_
 
 #include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <new>
+#include <type_traits>
 #include <stl_construct.hpp>
 
+#ifdef TINYSTL_ALLOC_STATS
+    #include <atomic>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/mman.h>
+    #define TINYSTL_HAS_MMAP
+#endif
+
 namespace TinySTL {
 
     // Primary allocator.
@@ -27,7 +40,7 @@ namespace TinySTL {
         }
 
         static void deallocate(void* ptr, size_t n) {
-            ::operator delete(ptr);
+            free(ptr);
         }
 
         static void* reallocate(void* ptr, size_t old_size, size_t new_size) {
@@ -89,10 +102,73 @@ namespace TinySTL {
 
     using malloc_alloc = __malloc_alloc_template<0>;
 
+    // Nodes to be deallocated together, linked through their first word.
+    // Containers destroy their nodes, push them into a chain,
+    // and give the whole chain to the allocator at once.
+    template <class T>
+    struct __node_chain {
+        T* head      = nullptr;
+        T* tail      = nullptr;
+        size_t count = 0;
+
+        // The node should be destroyed, its first word is overwritten.
+        void push(T* node) {
+            *reinterpret_cast<void**>(node) = head;
+            head                            = node;
+            if (tail == nullptr) {
+                tail = node;
+            }
+            ++count;
+        }
+    };
+
+    // Give a chain of `count` blocks of `n` bytes back to `a`,
+    // by `a.deallocate_chain` if it has one, otherwise block by block.
+    template <class Alloc>
+    auto __deallocate_chain(const Alloc& a, void* head, void* tail, size_t count, size_t n, int)
+        -> decltype(a.deallocate_chain(head, tail, count, n), void()) {
+        a.deallocate_chain(head, tail, count, n);
+    }
+
+    template <class Alloc>
+    void __deallocate_chain(const Alloc& a, void* head, void*, size_t count, size_t n, long) {
+        for (; count != 0; --count) {
+            void* next = *static_cast<void**>(head);
+            a.deallocate(head, n);
+            head = next;
+        }
+    }
+
+    // Resize a block of `a` from `old_size` to `new_size` bytes, keeping its bytes,
+    // by `a.reallocate` if it has one, otherwise by allocation and copy.
+    template <class Alloc>
+    auto __reallocate(const Alloc& a, void* ptr, size_t old_size, size_t new_size, int)
+        -> decltype(a.reallocate(ptr, old_size, new_size)) {
+        return ptr == nullptr ? a.allocate(new_size) : a.reallocate(ptr, old_size, new_size);
+    }
+
+    template <class Alloc>
+    void* __reallocate(const Alloc& a, void* ptr, size_t old_size, size_t new_size, long) {
+        void* space = a.allocate(new_size);
+        if (ptr != nullptr) {
+            memcpy(space, ptr, old_size < new_size ? old_size : new_size);
+            a.deallocate(ptr, old_size);
+        }
+        return space;
+    }
+
     // Encapsule the `alloc` as an interface.
-    template <class T, class Alloc>
+    // A stateless `Alloc` provides static functions and costs no space,
+    // a stateful one is copied into every `simple_alloc` and called through the copy.
+    // Containers inherit their `simple_alloc`, so a stateless one takes no space in them.
+    template <class T, class Alloc, bool = std::is_empty<Alloc>::value>
     class simple_alloc {
     public:
+        simple_alloc() = default;
+        simple_alloc(const Alloc&) {}
+
+        Alloc get_allocator() const { return Alloc(); }
+
         static T* allocate(size_t n) {
             return 0 == n ? nullptr : static_cast<T*>(Alloc::allocate(n * sizeof(T)));
         }
@@ -106,23 +182,311 @@ namespace TinySTL {
         static void deallocate(T* ptr) {
             Alloc::deallocate(ptr, sizeof(T));
         }
+        // Resize a buffer of trivially relocatable objects from `old_n` to `new_n` objects.
+        static T* reallocate(T* ptr, size_t old_n, size_t new_n) {
+            return static_cast<T*>(__reallocate(Alloc(), ptr, old_n * sizeof(T), new_n * sizeof(T), 0));
+        }
+        static void deallocate_chain(const __node_chain<T>& chain) {
+            if (0 != chain.count)
+                __deallocate_chain(Alloc(), chain.head, chain.tail, chain.count, sizeof(T), 0);
+        }
+    };
+
+    template <class T, class Alloc>
+    class simple_alloc<T, Alloc, false> {
+    private:
+        Alloc m_alloc;
+
+    public:
+        simple_alloc()
+            : m_alloc() {}
+        simple_alloc(const Alloc& a)
+            : m_alloc(a) {}
+
+        Alloc get_allocator() const { return m_alloc; }
+
+        T* allocate(size_t n) const {
+            return 0 == n ? nullptr : static_cast<T*>(m_alloc.allocate(n * sizeof(T)));
+        }
+        T* allocate(void) const {
+            return static_cast<T*>(m_alloc.allocate(sizeof(T)));
+        }
+        void deallocate(T* ptr, size_t n) const {
+            if (0 != n)
+                m_alloc.deallocate(ptr, n * sizeof(T));
+        }
+        void deallocate(T* ptr) const {
+            m_alloc.deallocate(ptr, sizeof(T));
+        }
+        T* reallocate(T* ptr, size_t old_n, size_t new_n) const {
+            return static_cast<T*>(__reallocate(m_alloc, ptr, old_n * sizeof(T), new_n * sizeof(T), 0));
+        }
+        void deallocate_chain(const __node_chain<T>& chain) const {
+            if (0 != chain.count)
+                __deallocate_chain(m_alloc, chain.head, chain.tail, chain.count, sizeof(T), 0);
+        }
+    };
+
+
+    // Counter of the allocator statistics.
+    // It does nothing unless `TINYSTL_ALLOC_STATS` is defined,
+    // so the fast paths pay nothing by default.
+    struct __alloc_stat_counter {
+#ifdef TINYSTL_ALLOC_STATS
+        std::atomic<size_t> value;
+
+        void add(size_t n) { value.fetch_add(n, std::memory_order_relaxed); }
+        size_t get() const { return value.load(std::memory_order_relaxed); }
+#else
+        void add(size_t) {}
+        size_t get() const { return 0; }
+#endif
+    };
+
+    // Counters of one size class.
+    struct __alloc_class_stats {
+        // Bytes of the class.
+        size_t size;
+        // Calls of `allocate` and `deallocate`.
+        size_t allocations;
+        size_t deallocations;
+        // Allocations served by the free list directly.
+        size_t hits;
+        // Calls of `refill` and the objects they got.
+        size_t refills;
+        size_t refill_objects;
+        // Bytes asked by the users, and bytes after rounding up to the class,
+        // the difference is the internal fragmentation.
+        size_t requested_bytes;
+        size_t rounded_bytes;
+    };
+
+    // A snapshot of the statistics of a secondary allocator.
+    template <size_t NFreeLists>
+    struct __alloc_stats {
+        // If false, `TINYSTL_ALLOC_STATS` is not defined and only the heap size is reported.
+        bool enabled;
+        __alloc_class_stats classes[NFreeLists];
+        // Chunks got from the system for the pool, and their bytes.
+        size_t chunks;
+        size_t chunk_bytes;
+        // Times that `chunk_alloc` failed to get memory from `malloc` and fell back.
+        size_t chunk_fallbacks;
+        // Blocks larger than the biggest class, handed to `malloc_alloc`.
+        size_t large_allocations;
+        size_t large_deallocations;
+        size_t large_bytes;
+        // Bytes currently owned by the pool, and bytes given back by `trim`.
+        size_t heap_size;
+        size_t released_bytes;
+
+        void dump(std::ostream& os) const {
+            if (!enabled) {
+                os << "allocator statistics are disabled, define TINYSTL_ALLOC_STATS to enable them.\n";
+                os << "heap size: " << heap_size << "\n";
+                return;
+            }
+            os << "class    allocs     frees      hits   refills   objects   waste(B)\n";
+            for (size_t i = 0; i < NFreeLists; ++i) {
+                const __alloc_class_stats& c = classes[i];
+                os << std::setw(5) << c.size
+                   << std::setw(10) << c.allocations
+                   << std::setw(10) << c.deallocations
+                   << std::setw(10) << c.hits
+                   << std::setw(10) << c.refills
+                   << std::setw(10) << c.refill_objects
+                   << std::setw(11) << (c.rounded_bytes - c.requested_bytes) << "\n";
+            }
+            os << "chunks: " << chunks << " (" << chunk_bytes << " bytes), fallbacks: " << chunk_fallbacks << "\n";
+            os << "large: " << large_allocations << " allocs, " << large_deallocations << " frees, " << large_bytes << " bytes\n";
+            os << "heap size: " << heap_size << ", released: " << released_bytes << "\n";
+        }
+    };
+
+    constexpr size_t __size_class_log2(size_t n) {
+        return n <= 1 ? 0 : 1 + __size_class_log2(n >> 1);
+    }
+
+    // Size classes of the secondary allocator.
+    // A size class policy provides:
+    // `_ALIGN`: every class is a multiply of it, and every object is aligned to it.
+    // `_MAX_BYTES`: the largest class, bigger blocks go to the primary allocator.
+    // `_NFREELISTS`: number of classes, one free list per class.
+    // `index(bytes)`: the class serving `bytes`, `bytes` should be in (0, `_MAX_BYTES`].
+    // `size(index)`: the bytes of the class.
+
+    // Classes of `Align`, 2 * `Align`, ..., `MaxBytes`.
+    // The default one is the 16 classes of 8, 16, ..., 128 bytes.
+    template <size_t Align = 8, size_t MaxBytes = 128>
+    struct __linear_size_class {
+        static_assert((Align & (Align - 1)) == 0 && Align >= sizeof(void*), "Align should be a power of 2 holding a pointer.");
+        static_assert(MaxBytes % Align == 0, "MaxBytes should be a multiply of Align.");
+
+        enum { _ALIGN = Align };
+        enum { _MAX_BYTES = MaxBytes };
+        enum { _NFREELISTS = MaxBytes / Align };
+
+        static size_t index(size_t bytes) { return (bytes + _ALIGN - 1) / _ALIGN - 1; }
+        static size_t size(size_t index) { return (index + 1) * _ALIGN; }
+    };
+
+    // Classes of `Align`, 2 * `Align`, ..., `LinearBytes`,
+    // then 4 classes for each power of 2 up to `MaxBytes`, e.g. 160, 192, 224, 256, 320, ...,
+    // so the waste of rounding is less than 25% for mid-size blocks.
+    template <size_t Align = 16, size_t LinearBytes = 128, size_t MaxBytes = 4096>
+    struct __geometric_size_class {
+        static_assert((Align & (Align - 1)) == 0 && Align >= sizeof(void*), "Align should be a power of 2 holding a pointer.");
+        static_assert((LinearBytes & (LinearBytes - 1)) == 0 && LinearBytes >= 4 * Align, "LinearBytes should be a power of 2, and no less than 4 * Align.");
+        static_assert((MaxBytes & (MaxBytes - 1)) == 0 && MaxBytes >= LinearBytes, "MaxBytes should be a power of 2, and no less than LinearBytes.");
+
+        enum { _ALIGN = Align };
+        enum { _MAX_BYTES = MaxBytes };
+        enum { _LINEAR_BYTES = LinearBytes };
+        enum { _LINEAR_LOG2 = __size_class_log2(LinearBytes) };
+        enum { _NLINEAR = LinearBytes / Align };
+        enum { _NFREELISTS = _NLINEAR + 4 * (__size_class_log2(MaxBytes) - _LINEAR_LOG2) };
+
+        static size_t index(size_t bytes) {
+            if (bytes <= _LINEAR_BYTES) {
+                return (bytes + _ALIGN - 1) / _ALIGN - 1;
+            }
+            // 2^k < bytes <= 2^(k + 1), split into 4 classes.
+            size_t k = __size_class_log2(bytes - 1);
+            return _NLINEAR + (k - _LINEAR_LOG2) * 4 + ((bytes - 1 - (size_t(1) << k)) >> (k - 2));
+        }
+
+        static size_t size(size_t index) {
+            if (index < _NLINEAR) {
+                return (index + 1) * _ALIGN;
+            }
+            size_t k = _LINEAR_LOG2 + (index - _NLINEAR) / 4;
+            return (size_t(1) << k) + ((index - _NLINEAR) % 4 + 1) * (size_t(1) << (k - 2));
+        }
+    };
+
+    // Refill policies decide how many objects `refill` asks `chunk_alloc` for.
+    // A refill policy provides:
+    // `initial(bytes)`: the first batch of the class of `bytes`.
+    // `next(last, distance, bytes)`: the next batch of the class, where `last` is its last batch,
+    // and `distance` is the number of refills of all classes since its last refill.
+
+    // Always `NObjs` objects, the classic behaviour.
+    template <int NObjs = 20>
+    struct __fixed_refill_policy {
+        static int initial(size_t) { return NObjs; }
+        static int next(int last, size_t, size_t) { return last; }
     };
 
+    // Grow the batch geometrically for the classes refilled often,
+    // and shrink it for the classes rarely refilled.
+    template <int Init = 20, int Min = 4, int Max = 512>
+    struct __adaptive_refill_policy {
+        static_assert(0 < Min && Min <= Init && Init <= Max, "Batch sizes should be 0 < Min <= Init <= Max.");
+
+        // Refilled again within this many refills, the class is hot.
+        enum { _HOT_DISTANCE = 2 };
+        // Not refilled within this many refills, the class is cold.
+        enum { _COLD_DISTANCE = 64 };
+        // Limit of the bytes of the first batch and of any batch.
+        enum { _INIT_BYTES = 2048 };
+        enum { _MAX_BYTES = 64 * 1024 };
+
+        static int clamp(size_t n, size_t bytes) {
+            size_t upper = _MAX_BYTES / bytes < (size_t)Max ? _MAX_BYTES / bytes : (size_t)Max;
+            n            = n > upper ? upper : n;
+            n            = n < (size_t)Min ? (size_t)Min : n;
+            return (int)n;
+        }
+
+        static int initial(size_t bytes) {
+            return clamp(_INIT_BYTES / bytes < (size_t)Init ? _INIT_BYTES / bytes : (size_t)Init, bytes);
+        }
+
+        static int next(int last, size_t distance, size_t bytes) {
+            if (distance <= _HOT_DISTANCE) {
+                return clamp((size_t)last * 2, bytes);
+            }
+            if (distance >= _COLD_DISTANCE) {
+                return clamp((size_t)last / 2, bytes);
+            }
+            return last;
+        }
+    };
+
+    // Chunk sources give the pool the memory of its chunks.
+    // A chunk source provides:
+    // `try_allocate(bytes)`: get a chunk of at least `bytes` bytes, nullptr if failed.
+    // `allocate(bytes)`: the same, but never returns nullptr.
+    // `deallocate(ptr, bytes)`: give a chunk back.
+    // `bytes` may be rounded up by the source, the pool uses all the rounded bytes.
+
+    // Chunks got by `malloc`, the classic behaviour.
+    struct __malloc_chunk_source {
+        static void* try_allocate(size_t& bytes) { return malloc(bytes); }
+        static void* allocate(size_t& bytes) { return malloc_alloc::allocate(bytes); }
+        static void deallocate(void* ptr, size_t bytes) { malloc_alloc::deallocate(ptr, bytes); }
+    };
+
+#ifdef TINYSTL_HAS_MMAP
+    // Chunks mapped by `mmap`, sized and aligned to `PageBytes`,
+    // and advised to be backed by transparent huge pages.
+    // Fewer TLB misses for the pointer chasing in large node-based containers.
+    template <size_t PageBytes = 2 * 1024 * 1024>
+    struct __mmap_chunk_source {
+        static_assert((PageBytes & (PageBytes - 1)) == 0, "PageBytes should be a power of 2.");
+
+        static void* try_allocate(size_t& bytes) {
+            bytes = (bytes + PageBytes - 1) & ~(PageBytes - 1);
+            // Map one more page, then unmap the misaligned head and tail.
+            char* space = (char*)mmap(nullptr, bytes + PageBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (space == (char*)MAP_FAILED) {
+                return nullptr;
+            }
+            char* first = (char*)(((size_t)space + PageBytes - 1) & ~(PageBytes - 1));
+            size_t head = first - space;
+            if (head != 0) {
+                munmap(space, head);
+            }
+            munmap(first + bytes, PageBytes - head);
+    #ifdef MADV_HUGEPAGE
+            madvise(first, bytes, MADV_HUGEPAGE);
+    #endif
+            return first;
+        }
+
+        static void* allocate(size_t& bytes) {
+            void* space = try_allocate(bytes);
+            if (space == nullptr) {
+                std::cerr << "Out of memory.\n";
+                exit(1);
+            }
+            return space;
+        }
+
+        static void deallocate(void* ptr, size_t bytes) { munmap(ptr, bytes); }
+    };
+#endif
 
     // Secondary allocator.
     // Apply internal interfaces for `stl_allocator`,
     // in responsible for memory allocation and deallocation.
-    template <bool threads, int inst>
+    // If `threads` is true, every thread owns a cache of the free lists,
+    // and the static free lists become a depot shared by all threads,
+    // which is only locked when a cache is refilled or flushed in batch.
+    // `SizeClass` decides which sizes are served by the free lists.
+    // `RefillPolicy` decides how many objects are got when a free list is empty.
+    // `ChunkSource` decides where the chunks of the pool come from.
+    template <bool threads, int inst, typename SizeClass = __linear_size_class<>, typename RefillPolicy = __adaptive_refill_policy<>, typename ChunkSource = __malloc_chunk_source>
     class __default_alloc_template {
     private:
-        // Small block should be the multiply of 8.
-        enum { _ALIGN = 8 };
+        // Small block should be the multiply of `_ALIGN`.
+        enum { _ALIGN = SizeClass::_ALIGN };
         // The max size of small block.
-        enum { _MAX_BYTES = 128 };
+        enum { _MAX_BYTES = SizeClass::_MAX_BYTES };
         // Number of free lists.
-        enum { _NFREELISTS = _MAX_BYTES / _ALIGN };
+        enum { _NFREELISTS = SizeClass::_NFREELISTS };
 
-        // Round up to be the multiplicity of 8.
+        // Round up to be the multiplicity of `_ALIGN`.
         static size_t Round_Up(size_t bytes) {
             return (((bytes) + _ALIGN - 1) & ~(_ALIGN - 1));
         }
@@ -133,12 +497,19 @@ namespace TinySTL {
             char client[1];
         };
 
-        // 16 free lists.
+        // One free list per size class.
+        // If `threads` is true, they are the depot shared by all threads.
         static obj* volatile free_list[_NFREELISTS];
         // Use the n^th free list, starting from 0.
         static size_t freelist_index(size_t bytes) {
-            return (((bytes) + _ALIGN - 1) / _ALIGN) - 1;
+            return SizeClass::index(bytes);
         }
+        // Round up to the size of its class.
+        static size_t class_size(size_t bytes) {
+            return SizeClass::size(SizeClass::index(bytes));
+        }
+        // Put [`first`, `first + bytes`) to the free lists, splitting it if it is not a class.
+        static void put_leftover(char* first, size_t bytes);
 
         // Return an object of size `n`,
         // and optionally adds to size `n` free list.
@@ -148,6 +519,16 @@ namespace TinySTL {
         // allocate the requested number.
         static char* chunk_alloc(size_t size, int& nobjs);
 
+        // Refill state of every class, used by `RefillPolicy`.
+        // The last batch, 0 if never refilled.
+        static int refill_objs[_NFREELISTS];
+        // The value of `refill_clock` at the last refill.
+        static size_t refill_stamp[_NFREELISTS];
+        // Number of refills of all classes.
+        static size_t refill_clock;
+        // Decide the batch of the class `index` for this refill.
+        static int refill_batch(size_t index);
+
         // Chunk allocation state
         // start position of free list
         static char* start_free;
@@ -155,52 +536,201 @@ namespace TinySTL {
         static char* end_free;
         static size_t heap_size;
 
+        // Every chunk got from the system starts with a header,
+        // so that the pool knows all the memory it owns.
+        struct chunk_header {
+            chunk_header* next;
+            // Bytes after the header.
+            size_t size;
+            // Bytes got from `ChunkSource`, including the header.
+            size_t source_bytes;
+            // Bytes of this chunk found on the free lists, only used by `trim`.
+            size_t free_bytes;
+        };
+        // The header and the padding to align the first object.
+        enum { _CHUNK_HEADER = sizeof(chunk_header) + _ALIGN - 1 };
+
+        // All the chunks owned by the pool.
+        static chunk_header* chunk_list;
+
+        static char* chunk_begin(chunk_header* chunk) { return (char*)Round_Up((size_t)chunk + sizeof(chunk_header)); }
+        static char* chunk_end(chunk_header* chunk) { return chunk_begin(chunk) + chunk->size; }
+        // Find the chunk containing `ptr` in `chunks` sorted by address.
+        static chunk_header* chunk_of(chunk_header** chunks, size_t n, const char* ptr);
+        static int chunk_compare(const void* lhs, const void* rhs);
+
+    private:
+        // Free lists owned by one thread, no lock is needed to access them.
+        // A cache gets one batch from the depot when its list is empty,
+        // and returns the objects beyond one batch when it holds more than 2 batches.
+        struct thread_cache {
+            obj* free_list[_NFREELISTS];
+            size_t count[_NFREELISTS];
+            // The last batch got from the depot.
+            size_t batch[_NFREELISTS];
+
+            thread_cache() {
+                for (int i = 0; i < _NFREELISTS; ++i) {
+                    free_list[i] = nullptr;
+                    count[i]     = 0;
+                    batch[i]     = RefillPolicy::initial(SizeClass::size(i));
+                }
+            }
+
+            // Give all the cached objects back to the depot when the thread exits.
+            ~thread_cache() {
+                std::lock_guard<std::mutex> guard(depot_mutex);
+                for (int i = 0; i < _NFREELISTS; ++i) {
+                    obj* head = free_list[i];
+                    if (head == nullptr) {
+                        continue;
+                    }
+                    obj* tail = head;
+                    while (tail->next != nullptr) {
+                        tail = tail->next;
+                    }
+                    tail->next                             = __default_alloc_template::free_list[i];
+                    __default_alloc_template::free_list[i] = head;
+                }
+            }
+        };
+
+        // Protect the depot and the chunk allocation state.
+        static std::mutex depot_mutex;
+
+        static thread_cache& local_cache() {
+            static thread_local thread_cache cache;
+            return cache;
+        }
+
+        // Thread cache version of `allocate`, `deallocate`, `deallocate_chain` and `refill`.
+        static void* thread_allocate(size_t n);
+        static void thread_deallocate(void* ptr, size_t n);
+        static void thread_deallocate_chain(obj* head, obj* tail, size_t count, size_t n);
+        static void* thread_refill(size_t n);
+        // Return the objects beyond one batch to the depot if the cache holds more than 2 batches.
+        static void thread_flush(thread_cache& cache, size_t index);
+
+    private:
+        struct class_counters {
+            __alloc_stat_counter allocations;
+            __alloc_stat_counter deallocations;
+            __alloc_stat_counter hits;
+            __alloc_stat_counter refills;
+            __alloc_stat_counter refill_objects;
+            __alloc_stat_counter requested_bytes;
+            __alloc_stat_counter rounded_bytes;
+        };
+
+        struct counters {
+            class_counters classes[_NFREELISTS];
+            __alloc_stat_counter chunks;
+            __alloc_stat_counter chunk_bytes;
+            __alloc_stat_counter chunk_fallbacks;
+            __alloc_stat_counter large_allocations;
+            __alloc_stat_counter large_deallocations;
+            __alloc_stat_counter large_bytes;
+            __alloc_stat_counter released_bytes;
+        };
+
+        static counters stat;
+
     public:
+        using stats_type = __alloc_stats<_NFREELISTS>;
+
         static void* allocate(size_t bytes);
 
         static void deallocate(void* ptr, size_t n);
 
+        // Deallocate `count` objects of size `n` linked through their first word, from `head` to `tail`.
+        // The chain is spliced into the free list at once.
+        static void deallocate_chain(void* head, void* tail, size_t count, size_t n);
+
         static void* reallocate(void* ptr, size_t old_size, size_t new_size);
+
+        // Give the chunks whose objects are all back on the free lists to the system.
+        // If `threads` is true, only the depot and the cache of the calling thread are checked.
+        // Return the number of bytes released.
+        static size_t trim();
+
+        // Take a snapshot of the statistics.
+        static stats_type stats();
+
+        static void dump_stats(std::ostream& os = std::cerr) { stats().dump(os); }
     };
 
-    template <bool threads, int inst>
-    char* __default_alloc_template<threads, inst>::start_free = 0;
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    typename __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::counters __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::stat;
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    char* __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::start_free = 0;
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    char* __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::end_free = 0;
 
-    template <bool threads, int inst>
-    char* __default_alloc_template<threads, inst>::end_free = 0;
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    size_t __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::heap_size = 0;
 
-    template <bool threads, int inst>
-    size_t __default_alloc_template<threads, inst>::heap_size = 0;
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    int __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::refill_objs[_NFREELISTS] = { 0 };
 
-    template <bool threads, int inst>
-    typename __default_alloc_template<threads, inst>::obj* volatile __default_alloc_template<threads, inst>::free_list[_NFREELISTS] = { 0 };
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    size_t __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::refill_stamp[_NFREELISTS] = { 0 };
 
-    template <bool threads, int inst>
-    void* __default_alloc_template<threads, inst>::allocate(size_t n) {
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    size_t __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::refill_clock = 0;
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    typename __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::chunk_header* __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::chunk_list = nullptr;
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    typename __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::obj* volatile __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::free_list[_NFREELISTS] = { 0 };
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    std::mutex __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::depot_mutex;
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    void* __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::allocate(size_t n) {
         // If more than 128, using primary allocator.
         if (n > (size_t)_MAX_BYTES) {
+            stat.large_allocations.add(1);
+            stat.large_bytes.add(n);
             return malloc_alloc::allocate(n);
         }
+        class_counters& counter = stat.classes[freelist_index(n)];
+        counter.allocations.add(1);
+        counter.requested_bytes.add(n);
+        counter.rounded_bytes.add(class_size(n));
+        if (threads) {
+            return thread_allocate(n);
+        }
 
         obj* volatile* my_free_list = free_list + freelist_index(n);
         obj* space                  = *my_free_list;
         if (space == nullptr) {
             // No available free list.
-            void* r = refill(Round_Up(n));
+            void* r = refill(class_size(n));
             return r;
         }
+        counter.hits.add(1);
         // Adjust free list.
         *my_free_list = space->next;
         return space;
     }
 
-    template <bool threads, int inst>
-    void __default_alloc_template<threads, inst>::deallocate(void* ptr, size_t n) {
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    void __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::deallocate(void* ptr, size_t n) {
         // If more than 128, using primary deallocator.
         if (n > (size_t)_MAX_BYTES) {
+            stat.large_deallocations.add(1);
             malloc_alloc::deallocate(ptr, n);
             return;
         }
+        stat.classes[freelist_index(n)].deallocations.add(1);
+        if (threads) {
+            thread_deallocate(ptr, n);
+            return;
+        }
 
         obj* volatile* my_free_list = free_list + freelist_index(n);
         obj* q                      = (obj*)ptr;
@@ -208,15 +738,45 @@ namespace TinySTL {
         *my_free_list               = q;
     }
 
-    template <bool threads, int inst>
-    void* __default_alloc_template<threads, inst>::reallocate(void* ptr, size_t old_size, size_t new_size) {
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    void __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::deallocate_chain(void* head, void* tail, size_t count, size_t n) {
+        if (count == 0) {
+            return;
+        }
+        // If more than 128, using primary deallocator one by one.
+        if (n > (size_t)_MAX_BYTES) {
+            stat.large_deallocations.add(count);
+            for (; count != 0; --count) {
+                void* next = ((obj*)head)->next;
+                malloc_alloc::deallocate(head, n);
+                head = next;
+            }
+            return;
+        }
+        stat.classes[freelist_index(n)].deallocations.add(count);
+        if (threads) {
+            thread_deallocate_chain((obj*)head, (obj*)tail, count, n);
+            return;
+        }
+
+        obj* volatile* my_free_list = free_list + freelist_index(n);
+        ((obj*)tail)->next          = *my_free_list;
+        *my_free_list               = (obj*)head;
+    }
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    void* __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::reallocate(void* ptr, size_t old_size, size_t new_size) {
         // If more than 128, using primary reallocator.
+        // Counted as a deallocation of the old block and an allocation of the new one.
         if (old_size > (size_t)_MAX_BYTES && new_size > (size_t)_MAX_BYTES) {
-            return realloc(ptr, new_size);
+            stat.large_deallocations.add(1);
+            stat.large_allocations.add(1);
+            stat.large_bytes.add(new_size);
+            return malloc_alloc::reallocate(ptr, old_size, new_size);
         }
 
         // If the size is the same, return the same pointer.
-        if (Round_Up(old_size) == Round_Up(new_size)) {
+        if (old_size <= (size_t)_MAX_BYTES && new_size <= (size_t)_MAX_BYTES && class_size(old_size) == class_size(new_size)) {
             return ptr;
         }
 
@@ -228,13 +788,136 @@ namespace TinySTL {
         return result;
     }
 
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    void* __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::thread_allocate(size_t n) {
+        thread_cache& cache = local_cache();
+        size_t index        = freelist_index(n);
+        obj* space          = cache.free_list[index];
+        if (space == nullptr) {
+            // No available object in this thread, ask the depot for a batch.
+            return thread_refill(class_size(n));
+        }
+        stat.classes[index].hits.add(1);
+        // Adjust free list, no lock is needed.
+        cache.free_list[index] = space->next;
+        --cache.count[index];
+        return space;
+    }
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    void __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::thread_deallocate(void* ptr, size_t n) {
+        thread_cache& cache    = local_cache();
+        size_t index           = freelist_index(n);
+        obj* q                 = (obj*)ptr;
+        q->next                = cache.free_list[index];
+        cache.free_list[index] = q;
+        ++cache.count[index];
+        thread_flush(cache, index);
+    }
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    void __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::thread_deallocate_chain(obj* head, obj* tail, size_t count, size_t n) {
+        thread_cache& cache = local_cache();
+        size_t index        = freelist_index(n);
+        // A long chain goes to the depot directly, its tail is known so no walk is needed.
+        if (count > cache.batch[index]) {
+            std::lock_guard<std::mutex> guard(depot_mutex);
+            tail->next       = free_list[index];
+            free_list[index] = head;
+            return;
+        }
+        tail->next             = cache.free_list[index];
+        cache.free_list[index] = head;
+        cache.count[index] += count;
+        thread_flush(cache, index);
+    }
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    void __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::thread_flush(thread_cache& cache, size_t index) {
+        // Too many objects in this thread, keep the latest ones and return the rest to the depot.
+        if (cache.count[index] > 2 * cache.batch[index]) {
+            obj* tail = cache.free_list[index];
+            for (size_t i = 1; i < cache.batch[index]; ++i) {
+                tail = tail->next;
+            }
+            obj* head          = tail->next;
+            tail->next         = nullptr;
+            cache.count[index] = cache.batch[index];
+
+            tail = head;
+            while (tail->next != nullptr) {
+                tail = tail->next;
+            }
+            std::lock_guard<std::mutex> guard(depot_mutex);
+            tail->next       = free_list[index];
+            free_list[index] = head;
+        }
+    }
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    void* __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::thread_refill(size_t n) {
+        thread_cache& cache = local_cache();
+        size_t index        = freelist_index(n);
+        obj* head           = nullptr;
+        int nobjs           = 0;
+        {
+            std::lock_guard<std::mutex> guard(depot_mutex);
+            int batch          = refill_batch(index);
+            cache.batch[index] = batch;
+            head               = free_list[index];
+            // Take a batch from the depot.
+            if (head != nullptr) {
+                obj* tail = head;
+                for (nobjs = 1; nobjs < batch && tail->next != nullptr; ++nobjs) {
+                    tail = tail->next;
+                }
+                free_list[index] = tail->next;
+                tail->next       = nullptr;
+            }
+            // The depot is empty, cut a new batch from the chunk.
+            else {
+                nobjs       = batch;
+                char* chunk = chunk_alloc(n, nobjs);
+                head        = (obj*)chunk;
+                for (int i = 1; i < nobjs; ++i) {
+                    ((obj*)(chunk + (i - 1) * n))->next = (obj*)(chunk + i * n);
+                }
+                ((obj*)(chunk + (nobjs - 1) * n))->next = nullptr;
+            }
+        }
+
+        stat.classes[index].refills.add(1);
+        stat.classes[index].refill_objects.add(nobjs);
+
+        // Return the first object and keep the rest in this thread.
+        cache.free_list[index] = head->next;
+        cache.count[index]     = nobjs - 1;
+        return head;
+    }
+
     typedef __default_alloc_template<false, 0> alloc;
 
-    template <bool threads, int inst>
-    void* __default_alloc_template<threads, inst>::refill(size_t n) {
-        int nobjs = 20;
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    int __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::refill_batch(size_t index) {
+        ++refill_clock;
+        int& nobjs = refill_objs[index];
+        if (nobjs == 0) {
+            nobjs = RefillPolicy::initial(SizeClass::size(index));
+        }
+        else {
+            nobjs = RefillPolicy::next(nobjs, refill_clock - refill_stamp[index], SizeClass::size(index));
+        }
+        refill_stamp[index] = refill_clock;
+        return nobjs;
+    }
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    void* __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::refill(size_t n) {
+        int nobjs = refill_batch(freelist_index(n));
 
         char* chunk = chunk_alloc(n, nobjs);
+        stat.classes[freelist_index(n)].refills.add(1);
+        stat.classes[freelist_index(n)].refill_objects.add(nobjs);
         // If get one chunk.
         if (nobjs == 1)
             return chunk;
@@ -258,8 +941,8 @@ namespace TinySTL {
         return space;
     }
 
-    template <bool threads, int inst>
-    char* __default_alloc_template<threads, inst>::chunk_alloc(size_t size, int& nobjs) {
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    char* __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::chunk_alloc(size_t size, int& nobjs) {
         size_t total_bytes = size * nobjs;
         size_t bytes_left  = end_free - start_free;
 
@@ -282,26 +965,28 @@ namespace TinySTL {
             size_t bytes_to_get = 2 * total_bytes + Round_Up(heap_size >> 4);
             // Try to make use of the left-over piece.
             if (bytes_left > 0) {
-                // Search for free list.
-                obj* volatile* my_free_list = free_list + freelist_index(bytes_left);
-                ((obj*)start_free)->next    = *my_free_list;
-                *my_free_list               = (obj*)start_free;
+                put_leftover(start_free, bytes_left);
             }
 
+            start_free = nullptr;
+            end_free   = nullptr;
+
             // Config heap space for memory pool.
-            start_free = (char*)malloc(bytes_to_get);
-            if (start_free == NULL) {
+            size_t source_bytes = _CHUNK_HEADER + bytes_to_get;
+            chunk_header* chunk = (chunk_header*)ChunkSource::try_allocate(source_bytes);
+            if (chunk == nullptr) {
+                stat.chunk_fallbacks.add(1);
                 // Malloc fails.
                 obj * volatile *my_free_list, *p;
                 // Search for unused and big enough free list.
-                for (int i = size; i <= _MAX_BYTES; i += _ALIGN) {
-                    my_free_list = free_list + freelist_index(i);
+                for (size_t i = freelist_index(size); i < (size_t)_NFREELISTS; ++i) {
+                    my_free_list = free_list + i;
                     p            = *my_free_list;
                     if (p != NULL) {
                         // Adjust free list.
                         *my_free_list = p->next;
                         start_free    = (char*)p;
-                        end_free      = start_free + i;
+                        end_free      = start_free + SizeClass::size(i);
                         // Adjust nobjs.
                         return chunk_alloc(size, nobjs);
                     }
@@ -309,14 +994,193 @@ namespace TinySTL {
                 // No any space.
                 end_free = NULL;
                 // This will throw exception.
-                start_free = (char*)malloc_alloc::allocate(bytes_to_get);
+                source_bytes = _CHUNK_HEADER + bytes_to_get;
+                chunk        = (chunk_header*)ChunkSource::allocate(source_bytes);
             }
+            // The source may give more than asked.
+            bytes_to_get = (source_bytes - _CHUNK_HEADER) & ~((size_t)_ALIGN - 1);
+            // Record the chunk.
+            chunk->next         = chunk_list;
+            chunk->size         = bytes_to_get;
+            chunk->source_bytes = source_bytes;
+            chunk_list          = chunk;
+            stat.chunks.add(1);
+            stat.chunk_bytes.add(bytes_to_get);
+
             heap_size += bytes_to_get;
-            end_free = start_free + bytes_to_get;
+            start_free = chunk_begin(chunk);
+            end_free   = start_free + bytes_to_get;
             return chunk_alloc(size, nobjs);
         }
     }
 
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    void __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::put_leftover(char* first, size_t bytes) {
+        // Every class and every chunk is a multiply of `_ALIGN`,
+        // so the leftover can always be split into classes.
+        while (bytes >= (size_t)_ALIGN) {
+            size_t index = freelist_index(bytes > (size_t)_MAX_BYTES ? (size_t)_MAX_BYTES : bytes);
+            if (SizeClass::size(index) > bytes) {
+                --index;
+            }
+            obj* volatile* my_free_list = free_list + index;
+            ((obj*)first)->next         = *my_free_list;
+            *my_free_list               = (obj*)first;
+            first += SizeClass::size(index);
+            bytes -= SizeClass::size(index);
+        }
+    }
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    int __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::chunk_compare(const void* lhs, const void* rhs) {
+        const chunk_header* l = *(chunk_header* const*)lhs;
+        const chunk_header* r = *(chunk_header* const*)rhs;
+        return l < r ? -1 : (r < l ? 1 : 0);
+    }
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    typename __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::chunk_header*
+    __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::chunk_of(chunk_header** chunks, size_t n, const char* ptr) {
+        // Binary search the last chunk starting no later than `ptr`.
+        size_t lo = 0, hi = n;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (chunk_begin(chunks[mid]) <= ptr) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        return chunks[lo - 1];
+    }
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    size_t __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::trim() {
+        std::unique_lock<std::mutex> guard(depot_mutex, std::defer_lock);
+        if (threads) {
+            guard.lock();
+            // Give the objects cached by this thread back to the depot first.
+            thread_cache& cache = local_cache();
+            for (int i = 0; i < _NFREELISTS; ++i) {
+                while (cache.free_list[i] != nullptr) {
+                    obj* q             = cache.free_list[i];
+                    cache.free_list[i] = q->next;
+                    q->next            = free_list[i];
+                    free_list[i]       = q;
+                }
+                cache.count[i] = 0;
+            }
+        }
+
+        size_t n = 0;
+        for (chunk_header* chunk = chunk_list; chunk != nullptr; chunk = chunk->next) {
+            chunk->free_bytes = 0;
+            ++n;
+        }
+        if (n == 0) {
+            return 0;
+        }
+
+        // Sort the chunks by address, so the owner of an object can be found by binary search.
+        chunk_header** chunks = (chunk_header**)malloc(n * sizeof(chunk_header*));
+        if (chunks == nullptr) {
+            return 0;
+        }
+        n = 0;
+        for (chunk_header* chunk = chunk_list; chunk != nullptr; chunk = chunk->next) {
+            chunks[n++] = chunk;
+        }
+        qsort(chunks, n, sizeof(chunk_header*), chunk_compare);
+
+        // Count the free bytes of every chunk.
+        for (int i = 0; i < _NFREELISTS; ++i) {
+            for (obj* p = free_list[i]; p != nullptr; p = p->next) {
+                chunk_of(chunks, n, (char*)p)->free_bytes += SizeClass::size(i);
+            }
+        }
+        if (start_free != end_free) {
+            chunk_of(chunks, n, start_free)->free_bytes += end_free - start_free;
+        }
+
+        // Drop the objects of the fully free chunks from the free lists.
+        for (int i = 0; i < _NFREELISTS; ++i) {
+            obj* volatile* link = free_list + i;
+            while (*link != nullptr) {
+                chunk_header* chunk = chunk_of(chunks, n, (char*)*link);
+                if (chunk->free_bytes == chunk->size) {
+                    *link = (*link)->next;
+                }
+                else {
+                    link = &(*link)->next;
+                }
+            }
+        }
+        if (start_free != end_free) {
+            chunk_header* chunk = chunk_of(chunks, n, start_free);
+            if (chunk->free_bytes == chunk->size) {
+                start_free = nullptr;
+                end_free   = nullptr;
+            }
+        }
+        free(chunks);
+
+        // Release the fully free chunks.
+        size_t released      = 0;
+        chunk_header** chunk = &chunk_list;
+        while (*chunk != nullptr) {
+            chunk_header* curr = *chunk;
+            if (curr->free_bytes == curr->size) {
+                *chunk = curr->next;
+                released += curr->size;
+                ChunkSource::deallocate(curr, curr->source_bytes);
+            }
+            else {
+                chunk = &curr->next;
+            }
+        }
+        heap_size -= released;
+        stat.released_bytes.add(released);
+        return released;
+    }
+
+    template <bool threads, int inst, typename SizeClass, typename RefillPolicy, typename ChunkSource>
+    typename __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::stats_type
+    __default_alloc_template<threads, inst, SizeClass, RefillPolicy, ChunkSource>::stats() {
+        stats_type result;
+#ifdef TINYSTL_ALLOC_STATS
+        result.enabled = true;
+#else
+        result.enabled = false;
+#endif
+        for (size_t i = 0; i < (size_t)_NFREELISTS; ++i) {
+            const class_counters& counter     = stat.classes[i];
+            result.classes[i].size            = SizeClass::size(i);
+            result.classes[i].allocations     = counter.allocations.get();
+            result.classes[i].deallocations   = counter.deallocations.get();
+            result.classes[i].hits            = counter.hits.get();
+            result.classes[i].refills         = counter.refills.get();
+            result.classes[i].refill_objects  = counter.refill_objects.get();
+            result.classes[i].requested_bytes = counter.requested_bytes.get();
+            result.classes[i].rounded_bytes   = counter.rounded_bytes.get();
+        }
+        result.chunks              = stat.chunks.get();
+        result.chunk_bytes         = stat.chunk_bytes.get();
+        result.chunk_fallbacks     = stat.chunk_fallbacks.get();
+        result.large_allocations   = stat.large_allocations.get();
+        result.large_deallocations = stat.large_deallocations.get();
+        result.large_bytes         = stat.large_bytes.get();
+        result.released_bytes      = stat.released_bytes.get();
+        {
+            std::unique_lock<std::mutex> guard(depot_mutex, std::defer_lock);
+            if (threads) {
+                guard.lock();
+            }
+            result.heap_size = heap_size;
+        }
+        return result;
+    }
+
 } // namespace TinySTL
 
 #endif // !_TINYSTL_ALLOC_HPP_
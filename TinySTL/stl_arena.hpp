@@ -0,0 +1,184 @@
+#ifndef _TINYSTL_ARENA_HPP_
+#define _TINYSTL_ARENA_HPP_
+
+#include <cstddef>
+#include <stl_alloc.hpp>
+
+namespace TinySTL {
+
+    // Monotonic arena, a bump pointer allocator.
+    // Deallocation does nothing except for the last allocation,
+    // all the memory is released at once by `release` or the destructor.
+    // It is not thread-safe.
+    class monotonic_arena {
+    private:
+        // Alignment of every allocation.
+        enum { _ALIGN = alignof(std::max_align_t) };
+        // Size of the first block if not given.
+        enum { _DEFAULT_BLOCK = 4096 };
+
+        // Blocks are linked before their usable space.
+        struct block {
+            block* next;
+            size_t size;
+        };
+
+        enum { _BLOCK_HEADER = (sizeof(block) + _ALIGN - 1) & ~((size_t)_ALIGN - 1) };
+
+        static size_t Round_Up(size_t bytes) {
+            return (bytes + _ALIGN - 1) & ~((size_t)_ALIGN - 1);
+        }
+
+    private:
+        // Blocks malloced by the arena, the newest first.
+        block* m_blocks;
+        // The buffer given by the user, never freed.
+        char* m_buffer;
+        size_t m_buffer_size;
+        // Free space of the current block.
+        char* m_cur;
+        char* m_end;
+        // Start of the last allocation, which can be grown or given back in place.
+        char* m_last;
+        // Size of the next block.
+        size_t m_next_block;
+        // Bytes handed out since the last release.
+        size_t m_used;
+
+        // Get a block for at least `bytes` bytes.
+        void new_block(size_t bytes) {
+            size_t size = m_next_block;
+            while (size < bytes) {
+                size *= 2;
+            }
+            block* b     = static_cast<block*>(malloc_alloc::allocate(_BLOCK_HEADER + size));
+            b->next      = m_blocks;
+            b->size      = size;
+            m_blocks     = b;
+            m_cur        = reinterpret_cast<char*>(b) + _BLOCK_HEADER;
+            m_end        = m_cur + size;
+            m_last       = nullptr;
+            m_next_block = size * 2;
+        }
+
+        void reset_buffer() {
+            m_cur  = m_buffer;
+            m_end  = m_buffer + m_buffer_size;
+            m_last = nullptr;
+        }
+
+    public:
+        explicit monotonic_arena(size_t block_size = _DEFAULT_BLOCK)
+            : m_blocks(nullptr)
+            , m_buffer(nullptr)
+            , m_buffer_size(0)
+            , m_cur(nullptr)
+            , m_end(nullptr)
+            , m_last(nullptr)
+            , m_next_block(block_size != 0 ? Round_Up(block_size) : (size_t)_DEFAULT_BLOCK)
+            , m_used(0) {}
+
+        // Allocate from `buffer` first, e.g. a buffer on the stack.
+        monotonic_arena(void* buffer, size_t size)
+            : m_blocks(nullptr)
+            , m_buffer(nullptr)
+            , m_buffer_size(0)
+            , m_cur(nullptr)
+            , m_end(nullptr)
+            , m_last(nullptr)
+            , m_next_block(size > _DEFAULT_BLOCK ? Round_Up(size) : (size_t)_DEFAULT_BLOCK)
+            , m_used(0) {
+            // Align the buffer.
+            char* first = reinterpret_cast<char*>(Round_Up(reinterpret_cast<size_t>(buffer)));
+            if (first < static_cast<char*>(buffer) + size) {
+                m_buffer      = first;
+                m_buffer_size = (static_cast<char*>(buffer) + size - first) & ~((size_t)_ALIGN - 1);
+                reset_buffer();
+            }
+        }
+
+        monotonic_arena(const monotonic_arena&)            = delete;
+        monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+        ~monotonic_arena() { release(); }
+
+        void* allocate(size_t n) {
+            n = Round_Up(n != 0 ? n : 1);
+            if ((size_t)(m_end - m_cur) < n) {
+                new_block(n);
+            }
+            m_last = m_cur;
+            m_cur += n;
+            m_used += n;
+            return m_last;
+        }
+
+        // Only the last allocation is given back.
+        void deallocate(void* ptr, size_t n) {
+            if (ptr != nullptr && ptr == m_last && m_last + Round_Up(n != 0 ? n : 1) == m_cur) {
+                m_used -= m_cur - m_last;
+                m_cur  = m_last;
+                m_last = nullptr;
+            }
+        }
+
+        // Grow or shrink the last allocation in place if possible, otherwise copy it.
+        void* reallocate(void* ptr, size_t old_size, size_t new_size) {
+            if (ptr == nullptr) {
+                return allocate(new_size);
+            }
+            size_t old_bytes = Round_Up(old_size != 0 ? old_size : 1);
+            size_t new_bytes = Round_Up(new_size != 0 ? new_size : 1);
+            if (ptr == m_last && m_last + old_bytes == m_cur && (size_t)(m_end - m_last) >= new_bytes) {
+                m_cur  = m_last + new_bytes;
+                m_used = m_used - old_bytes + new_bytes;
+                return ptr;
+            }
+            if (new_bytes <= old_bytes) {
+                return ptr;
+            }
+            void* space = allocate(new_size);
+            memcpy(space, ptr, old_size);
+            return space;
+        }
+
+        // Free all the blocks, the user buffer is reused.
+        void release() {
+            while (m_blocks != nullptr) {
+                block* next = m_blocks->next;
+                malloc_alloc::deallocate(m_blocks, _BLOCK_HEADER + m_blocks->size);
+                m_blocks = next;
+            }
+            reset_buffer();
+            m_used = 0;
+        }
+
+        // Bytes handed out since the last release.
+        size_t used() const { return m_used; }
+    };
+
+    // Handle of a `monotonic_arena`, used as the `Alloc` of the containers,
+    // e.g. `list<int, arena_alloc>`. The arena should outlive the containers.
+    class arena_alloc {
+    private:
+        monotonic_arena* m_arena;
+
+    public:
+        arena_alloc(monotonic_arena& arena)
+            : m_arena(&arena) {}
+
+        void* allocate(size_t n) const { return m_arena->allocate(n); }
+        void deallocate(void* ptr, size_t n) const { m_arena->deallocate(ptr, n); }
+        // Nothing to give back, the nodes are released with the arena.
+        void deallocate_chain(void*, void*, size_t, size_t) const {}
+        void* reallocate(void* ptr, size_t old_size, size_t new_size) const { return m_arena->reallocate(ptr, old_size, new_size); }
+
+        monotonic_arena& arena() const { return *m_arena; }
+
+        friend bool operator==(const arena_alloc& lhs, const arena_alloc& rhs) { return lhs.m_arena == rhs.m_arena; }
+        friend bool operator!=(const arena_alloc& lhs, const arena_alloc& rhs) { return lhs.m_arena != rhs.m_arena; }
+    };
+
+} // namespace TinySTL
+
+#endif // !_TINYSTL_ARENA_HPP_
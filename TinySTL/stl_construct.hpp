@@ -2,6 +2,8 @@
 #define _TINYSTL_CONSTRUCT_HPP_
 
 #include <new>
+#include <utility>
+#include <stl_iterator.hpp>
 #include <stl_type_traits.hpp>
 
 namespace TinySTL {
@@ -21,6 +23,12 @@ namespace TinySTL {
         new (ptr) T();
     }
 
+    // Construct with arguments.
+    template <typename T, typename... Args>
+    inline void construct(T* ptr, Args&&... args) {
+        new (ptr) T(std::forward<Args>(args)...);
+    }
+
     // Destruct one object.
     template <typename T>
     inline void destory(T* ptr) {
@@ -0,0 +1,251 @@
+#ifndef _TINYSTL_DEBUG_ALLOC_HPP_
+#define _TINYSTL_DEBUG_ALLOC_HPP_
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <stl_alloc.hpp>
+
+namespace TinySTL {
+
+    // Debug allocator, a checking layer over `Alloc`.
+    // Every block is `[header][user bytes][guard]`, the header records the size,
+    // the call site and the size class in `SizeClass`, and links all the live blocks.
+    // `deallocate(ptr, n)` checks that `ptr` is live, `n` is the allocated size and the guard is intact.
+    // Freed blocks are poisoned and kept in a small quarantine before going back to `Alloc`,
+    // so that double frees and writes after free are caught.
+    // `report_leaks()` prints the blocks still live, `report_leaks_at_exit()` asks for it at exit.
+    // Errors go to the error handler, which prints the error and aborts by default.
+    template <typename Alloc, typename SizeClass = __linear_size_class<>>
+    class __debug_alloc_template {
+    private:
+        enum { _ALIGN = alignof(std::max_align_t) };
+        // Freed blocks kept away from `Alloc`.
+        enum { _QUARANTINE = 64 };
+
+        enum : unsigned { _LIVE = 0x4c495645u, _FREED = 0x46524545u };
+        // Bytes written into fresh and freed blocks.
+        enum : unsigned char { _FRESH_BYTE = 0xcd, _FREED_BYTE = 0xdd };
+        static const unsigned long long _GUARD = 0xfdfdfdfdfdfdfdfdull;
+
+        struct block_header {
+            block_header* prev;
+            block_header* next;
+            // Bytes asked by the user.
+            size_t size;
+            // Return address of the caller of `allocate`.
+            const void* site;
+            // Index in `SizeClass`, -1 if larger than the pooled sizes.
+            int size_class;
+            unsigned magic;
+        };
+
+        enum { _HEADER = (sizeof(block_header) + _ALIGN - 1) & ~((size_t)_ALIGN - 1) };
+
+        static size_t total_bytes(size_t n) { return _HEADER + n + sizeof(_GUARD); }
+        static block_header* header_of(void* ptr) { return (block_header*)((char*)ptr - _HEADER); }
+        static char* user_of(block_header* h) { return (char*)h + _HEADER; }
+
+        struct registry {
+            std::mutex mutex;
+            // Sentinel of the live blocks.
+            block_header live;
+            size_t live_blocks;
+            size_t live_bytes;
+            // Ring of freed blocks.
+            block_header* quarantine[_QUARANTINE];
+            size_t quarantine_next;
+
+            registry()
+                : live_blocks(0)
+                , live_bytes(0)
+                , quarantine_next(0) {
+                live.prev = live.next = &live;
+                for (int i = 0; i < _QUARANTINE; ++i) {
+                    quarantine[i] = nullptr;
+                }
+            }
+        };
+
+        // Never destroyed. A container with static storage duration constructed before the registry
+        // frees its blocks after the registry's destructor would have run.
+        static registry& reg() {
+            static registry* r = new registry;
+            return *r;
+        }
+
+        static void exit_report() {
+            report_leaks(std::cerr);
+        }
+
+        static void (*error_handler)(const char* what, const void* ptr, const void* site);
+
+        static void default_error_handler(const char* what, const void* ptr, const void* site) {
+            std::cerr << "TinySTL debug_alloc: " << what << " at " << ptr << ", allocated by " << site << ".\n";
+            abort();
+        }
+
+        static void error(const char* what, const void* ptr, const void* site) {
+            (*error_handler)(what, ptr, site);
+        }
+
+        static bool guard_intact(block_header* h) {
+            unsigned long long guard;
+            memcpy(&guard, user_of(h) + h->size, sizeof(guard));
+            return guard == _GUARD;
+        }
+
+        static bool poison_intact(block_header* h) {
+            const unsigned char* first = (const unsigned char*)user_of(h);
+            for (size_t i = 0; i < h->size; ++i) {
+                if (first[i] != _FREED_BYTE) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Give the oldest quarantined block back to `Alloc` and put `h` in its place.
+        static void quarantine(registry& r, block_header* h) {
+            block_header* old               = r.quarantine[r.quarantine_next];
+            r.quarantine[r.quarantine_next] = h;
+            r.quarantine_next               = (r.quarantine_next + 1) % _QUARANTINE;
+            if (old != nullptr) {
+                if (!poison_intact(old)) {
+                    error("write after free", user_of(old), old->site);
+                }
+                Alloc::deallocate(old, total_bytes(old->size));
+            }
+        }
+
+        static size_t report_leaks(registry& r, std::ostream& os) {
+            for (block_header* h = r.live.next; h != &r.live; h = h->next) {
+                os << "TinySTL debug_alloc: leak of " << h->size << " bytes";
+                if (h->size_class >= 0) {
+                    os << " (class " << SizeClass::size(h->size_class) << ")";
+                }
+                os << " at " << (void*)user_of(h) << ", allocated by " << h->site << ".\n";
+            }
+            return r.live_blocks;
+        }
+
+    public:
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((noinline)) static void* allocate(size_t n) {
+            return allocate_at(n, __builtin_return_address(0));
+        }
+#else
+        static void* allocate(size_t n) {
+            return allocate_at(n, nullptr);
+        }
+#endif
+
+        // Allocate `n` bytes and record `site` as the call site.
+        static void* allocate_at(size_t n, const void* site) {
+            block_header* h = (block_header*)Alloc::allocate(total_bytes(n));
+            h->size         = n;
+            h->site         = site;
+            h->size_class   = (n != 0 && n <= (size_t)SizeClass::_MAX_BYTES) ? (int)SizeClass::index(n) : -1;
+            h->magic        = _LIVE;
+            memset(user_of(h), _FRESH_BYTE, n);
+            memcpy(user_of(h) + n, &_GUARD, sizeof(_GUARD));
+
+            registry& r = reg();
+            std::lock_guard<std::mutex> guard(r.mutex);
+            h->prev           = &r.live;
+            h->next           = r.live.next;
+            r.live.next->prev = h;
+            r.live.next       = h;
+            ++r.live_blocks;
+            r.live_bytes += n;
+            return user_of(h);
+        }
+
+        static void deallocate(void* ptr, size_t n) {
+            if (ptr == nullptr) {
+                return;
+            }
+            block_header* h = header_of(ptr);
+            registry& r     = reg();
+            std::lock_guard<std::mutex> guard(r.mutex);
+            if (h->magic == _FREED) {
+                error("double free", ptr, h->site);
+                return;
+            }
+            if (h->magic != _LIVE) {
+                error("free of a block not allocated here", ptr, nullptr);
+                return;
+            }
+            if (h->size != n) {
+                error("size mismatch on free", ptr, h->site);
+            }
+            if (!guard_intact(h)) {
+                error("write past the end", ptr, h->site);
+            }
+            h->prev->next = h->next;
+            h->next->prev = h->prev;
+            --r.live_blocks;
+            r.live_bytes -= h->size;
+
+            h->magic = _FREED;
+            memset(ptr, _FREED_BYTE, h->size);
+            quarantine(r, h);
+        }
+
+        static void* reallocate(void* ptr, size_t old_size, size_t new_size) {
+            void* result = allocate_at(new_size, ptr != nullptr ? header_of(ptr)->site : nullptr);
+            if (ptr != nullptr) {
+                memcpy(result, ptr, old_size < new_size ? old_size : new_size);
+                deallocate(ptr, old_size);
+            }
+            return result;
+        }
+
+        // Number and bytes of the blocks not yet deallocated.
+        static size_t live_blocks() {
+            registry& r = reg();
+            std::lock_guard<std::mutex> guard(r.mutex);
+            return r.live_blocks;
+        }
+
+        static size_t live_bytes() {
+            registry& r = reg();
+            std::lock_guard<std::mutex> guard(r.mutex);
+            return r.live_bytes;
+        }
+
+        // Print the live blocks, return their number.
+        static size_t report_leaks(std::ostream& os = std::cerr) {
+            registry& r = reg();
+            std::lock_guard<std::mutex> guard(r.mutex);
+            return report_leaks(r, os);
+        }
+
+        // Print the live blocks when the program exits, from a handler registered with `atexit`.
+        // Objects with static storage duration constructed before this call are destroyed after
+        // the report, so their blocks are listed as well.
+        static void report_leaks_at_exit() {
+            static bool registered = (std::atexit(&exit_report), true);
+            (void)registered;
+        }
+
+        static void (*set_error_handler(void (*f)(const char*, const void*, const void*)))(const char*, const void*, const void*) {
+            void (*old)(const char*, const void*, const void*) = error_handler;
+            error_handler                                      = f;
+            return old;
+        }
+    };
+
+    template <typename Alloc, typename SizeClass>
+    void (*__debug_alloc_template<Alloc, SizeClass>::error_handler)(const char*, const void*, const void*) = &__debug_alloc_template<Alloc, SizeClass>::default_error_handler;
+
+    template <typename Alloc, typename SizeClass>
+    const unsigned long long __debug_alloc_template<Alloc, SizeClass>::_GUARD;
+
+    using debug_alloc = __debug_alloc_template<alloc>;
+
+} // namespace TinySTL
+
+#endif // !_TINYSTL_DEBUG_ALLOC_HPP_
@@ -1,6 +1,7 @@
 #ifndef _TINYSTL_DEQUE_HPP_
 #define _TINYSTL_DEQUE_HPP_
 
+#include <utility>
 #include <stl_algorithm.hpp>
 #include <stl_allocator.hpp>
 #include <stl_iterator.hpp>
@@ -13,6 +14,33 @@ namespace TinySTL {
         return n != 0 ? n : (size < 512 ? size_t(512 / size) : size_t(1));
     }
 
+    // Buffer policies decide the buffers of a deque.
+    // A buffer policy provides:
+    // `size(bytes)`: the number of elements of `bytes` bytes in a buffer, a constant expression.
+    // `spare`: the number of emptied buffers a deque keeps for reuse,
+    // so that a queue moving across a buffer boundary back and forth does not allocate every time.
+    // No spares by default, `alloc` hands out a buffer about as fast. Keep some for a slow allocator.
+
+    // Buffers of `Bytes` bytes, or one element if it is larger.
+    template <size_t Bytes = 512, size_t Spare = 0>
+    struct __bytes_buffer_policy {
+        enum : size_t { spare = Spare };
+
+        static constexpr size_t size(size_t bytes) {
+            return bytes < Bytes ? Bytes / bytes : 1;
+        }
+    };
+
+    // Buffers of a page, fewer buffers for large queues.
+    template <size_t Spare = 0>
+    using __page_buffer_policy = __bytes_buffer_policy<4096, Spare>;
+
+    // Number of elements in a buffer, `n` if it is given, otherwise decided by `BufferPolicy`.
+    template <typename BufferPolicy>
+    constexpr size_t __deque_buffer_size(size_t n, size_t size) {
+        return n != 0 ? n : BufferPolicy::size(size);
+    }
+
     template <typename T, typename Ref, typename Ptr, size_t BufSize>
     struct deque_iterator {
         static constexpr size_t buffer_size() {
@@ -111,7 +139,7 @@ namespace TinySTL {
             return *this;
         }
 
-        deque_iterator operator+(difference_type n) {
+        deque_iterator operator+(difference_type n) const {
             deque_iterator temp = *this;
             return temp += n;
         }
@@ -120,7 +148,7 @@ namespace TinySTL {
             return *this += (-n);
         }
 
-        deque_iterator operator-(difference_type n) {
+        deque_iterator operator-(difference_type n) const {
             deque_iterator temp = *this;
             return temp -= n;
         }
@@ -129,14 +157,35 @@ namespace TinySTL {
             return *((*this + n));
         }
 
-        friend bool operator==(const map& lhs, const map& rhs) noexcept { return lhs.m_curr == rhs.m_curr; }
-        friend bool operator!=(const map& lhs, const map& rhs) noexcept { return !(lhs == rhs); }
-        friend bool operator<(const map& lhs, const map& rhs) noexcept {
+        friend bool operator==(const self& lhs, const self& rhs) noexcept { return lhs.m_curr == rhs.m_curr; }
+        friend bool operator!=(const self& lhs, const self& rhs) noexcept { return !(lhs == rhs); }
+        friend bool operator<(const self& lhs, const self& rhs) noexcept {
             return (lhs.m_node == rhs.m_node) ? (lhs.m_curr < rhs.m_curr) : (lhs.m_node < rhs.m_node);
         }
-        friend bool operator>(const map& lhs, const map& rhs) noexcept { return rhs < lhs; }
-        friend bool operator<=(const map& lhs, const map& rhs) noexcept { return !(rhs < lhs); }
-        friend bool operator>=(const map& lhs, const map& rhs) noexcept { return !(lhs < rhs); }
+        friend bool operator>(const self& lhs, const self& rhs) noexcept { return rhs < lhs; }
+        friend bool operator<=(const self& lhs, const self& rhs) noexcept { return !(rhs < lhs); }
+        friend bool operator>=(const self& lhs, const self& rhs) noexcept { return !(lhs < rhs); }
+    };
+
+    // A deque iterator is segmented by the buffers.
+    template <typename T, typename Ref, typename Ptr, size_t BufSize>
+    struct __segmented_iterator_traits<deque_iterator<T, Ref, Ptr, BufSize>> {
+        using is_segmented     = __true_type;
+        using iterator         = deque_iterator<T, Ref, Ptr, BufSize>;
+        using segment_iterator = typename iterator::map_pointer;
+        using local_iterator   = Ptr;
+
+        static segment_iterator segment(const iterator& it) { return it.m_node; }
+        static local_iterator local(const iterator& it) { return it.m_curr; }
+        static local_iterator begin(segment_iterator segment) { return *segment; }
+        static local_iterator end(segment_iterator segment) { return *segment + iterator::buffer_size(); }
+
+        static iterator compose(segment_iterator segment, local_iterator local) {
+            iterator it;
+            it.set_node(segment);
+            it.m_curr = local;
+            return it;
+        }
     };
 
     template <typename T, typename Ref, typename Ptr, size_t BufSize>
@@ -154,8 +203,12 @@ namespace TinySTL {
         return random_access_iterator_tag();
     }
 
-    template <typename T, typename Alloc = alloc, size_t BufSize = 0>
-    class deque {
+    template <typename T, typename Alloc = alloc, size_t BufSize = 0, typename BufferPolicy = __bytes_buffer_policy<>>
+    class deque : private simple_alloc<T, Alloc>, private simple_alloc<T*, Alloc> {
+    private:
+        enum : size_t { _BUFFER_SIZE = __deque_buffer_size<BufferPolicy>(BufSize, sizeof(T)) };
+        enum : size_t { _SPARE = BufferPolicy::spare };
+
     public:
         using value_type      = T;
         using pointer         = T*;
@@ -165,8 +218,9 @@ namespace TinySTL {
         using size_type       = size_t;
         using difference_type = ptrdiff_t;
 
-        using iterator       = deque_iterator<T, T&, T*, BufSize>;
-        using const_iterator = deque_iterator<T, const T&, const T*, BufSize>;
+        using iterator       = deque_iterator<T, T&, T*, _BUFFER_SIZE>;
+        using const_iterator = deque_iterator<T, const T&, const T*, _BUFFER_SIZE>;
+        using allocator_type = Alloc;
 
     protected:
         using node_allocator = simple_alloc<T, Alloc>;
@@ -177,9 +231,14 @@ namespace TinySTL {
         iterator m_finish;
         size_type m_map_size;
         map_pointer m_map;
+        // Emptied buffers kept for reuse.
+        pointer m_spare[_SPARE != 0 ? size_t(_SPARE) : size_t(1)] = {};
+        size_type m_spare_count                                  = 0;
 
         enum class MapSize { MAP_SIZE = 8 };
 
+        static constexpr size_t buffer_size() { return _BUFFER_SIZE; }
+
     public:
         map_pointer allocate_map(size_t n) { return map_allocator::allocate(n); }
 
@@ -196,12 +255,12 @@ namespace TinySTL {
                 // If the `m_start` node changed.
                 if (new_start_node < m_start.m_node) {
                     // Copy [`m_start.m_first`, `m_finish.m_last`) to [`new_start_node.m_first`, `new_start_node + old_num_nodes.m_last`).
-                    copy(m_start.m_node, m_finish.m_node + 1, new_start_node);
+                    TinySTL::copy(m_start.m_node, m_finish.m_node + 1, new_start_node);
                 }
                 // If the `m_finish` node changed.
                 else {
                     // Copy [`m_start.m_first`, `m_finish.m_last`) to [`new_start_node.m_first`, `new_start_node + old_num_nodes.m_last`).
-                    copy_backward(m_start.m_node, m_finish.m_node + 1, new_start_node + old_num_nodes);
+                    TinySTL::copy_backward(m_start.m_node, m_finish.m_node + 1, new_start_node + old_num_nodes);
                 }
             }
             else {
@@ -210,7 +269,7 @@ namespace TinySTL {
                 map_pointer new_map    = allocate_map(new_map_size);
                 new_start_node         = new_map + (new_map_size - new_num_nodes) / 2 + (add_at_front ? node_to_add : 0);
                 // Copy [`m_start.m_first`, `m_finish.m_last`) to [`new_start_node.m_first`, `new_start_node + old_num_nodes.m_last`).
-                copy(m_start.m_node, m_finish.m_node + 1, new_start_node);
+                TinySTL::copy(m_start.m_node, m_finish.m_node + 1, new_start_node);
                 deallocate_map(m_map, m_map_size);
                 m_map      = new_map;
                 m_map_size = new_map_size;
@@ -222,7 +281,7 @@ namespace TinySTL {
 
         void initialize_map(size_type num_elements) {
             // First allocate a map.
-            size_type num_nodes = num_elements / deque_buffer_size(BufSize, sizeof(T)) + 1;
+            size_type num_nodes = num_elements / buffer_size() + 1;
             m_map_size          = std::max((size_type)(MapSize::MAP_SIZE), num_nodes + 2);
             m_map               = allocate_map(m_map_size);
 
@@ -233,6 +292,7 @@ namespace TinySTL {
                 create_nodes(start_node, finish_node);
             }
             catch (const std::exception&) {
+                release_spare_nodes();
                 deallocate_map(m_map, m_map_size);
                 m_map      = nullptr;
                 m_map_size = 0;
@@ -242,15 +302,31 @@ namespace TinySTL {
             m_start.set_node(start_node);
             m_start.m_curr = m_start.m_first;
             m_finish.set_node(finish_node - 1);
-            m_finish.m_curr = m_finish.m_first + num_elements % deque_buffer_size(BufSize, sizeof(T));
+            m_finish.m_curr = m_finish.m_first + num_elements % buffer_size();
         }
 
+        // Take a spare buffer if there is one.
         pointer allocate_node() {
-            return node_allocator::allocate(deque_buffer_size(BufSize, sizeof(T)));
+            if (m_spare_count != 0) {
+                return m_spare[--m_spare_count];
+            }
+            return node_allocator::allocate(buffer_size());
         }
 
+        // Keep the buffer as a spare if there is room.
         void deallocate_node(pointer node) {
-            node_allocator::deallocate(node, deque_buffer_size(BufSize, sizeof(T)));
+            if (m_spare_count < _SPARE) {
+                m_spare[m_spare_count++] = node;
+            }
+            else {
+                node_allocator::deallocate(node, buffer_size());
+            }
+        }
+
+        void release_spare_nodes() {
+            while (m_spare_count != 0) {
+                node_allocator::deallocate(m_spare[--m_spare_count], buffer_size());
+            }
         }
 
         void create_nodes(map_pointer start_node, map_pointer finish_node) {
@@ -279,13 +355,13 @@ namespace TinySTL {
             try {
                 // Fill each node.
                 for (; curr_node < m_finish.m_node; ++curr_node) {
-                    uninitialized_fill(*curr_node, *curr_node + deque_buffer_size(BufSize, sizeof(T)), value);
+                    TinySTL::uninitialized_fill(*curr_node, *curr_node + buffer_size(), value);
                 }
                 // Fill the last node.
-                uninitialized_fill(m_finish.m_first, m_finish.m_curr, value);
+                TinySTL::uninitialized_fill(m_finish.m_first, m_finish.m_curr, value);
             }
             catch (const std::exception&) {
-                destroy(m_start, iterator(*curr_node, curr_node));
+                destory(m_start, iterator(*curr_node, curr_node));
                 throw;
             }
         }
@@ -313,7 +389,7 @@ namespace TinySTL {
         }
 
         void new_elements_at_front(size_type n) {
-            size_type new_nodes = (n + deque_buffer_size(BufSize, sizeof(T)) - 1) / deque_buffer_size(BufSize, sizeof(T));
+            size_type new_nodes = (n + buffer_size() - 1) / buffer_size();
             reserve_map_at_front(new_nodes);
             size_type i;
             try {
@@ -330,7 +406,7 @@ namespace TinySTL {
         }
 
         void new_elements_at_back(size_type n) {
-            size_type new_nodes = (n + deque_buffer_size(BufSize, sizeof(T)) - 1) / deque_buffer_size(BufSize, sizeof(T));
+            size_type new_nodes = (n + buffer_size() - 1) / buffer_size();
             reserve_map_at_back(new_nodes);
             size_type i;
             try {
@@ -360,13 +436,14 @@ namespace TinySTL {
             }
         }
 
-        void push_back_aux(const value_type& value) {
+        template <typename... Args>
+        void push_back_aux(Args&&... args) {
             // Allocate a new node at the back.
             reserve_map_at_back();
             *(m_finish.m_node + 1) = allocate_node();
             try {
                 // Construct the new element at the end of the old node.
-                construct(m_finish.m_curr, value);
+                construct(m_finish.m_curr, std::forward<Args>(args)...);
                 // Switch to the new node.
                 m_finish.set_node(m_finish.m_node + 1);
                 m_finish.m_curr = m_finish.m_first;
@@ -377,24 +454,8 @@ namespace TinySTL {
             }
         }
 
-        void push_back_aux() {
-            // Allocate a new node at the back.
-            reserve_map_at_back();
-            *(m_finish.m_node + 1) = allocate_node();
-            try {
-                // Construct the new element at the end of the old node.
-                construct(m_finish.m_curr);
-                // Switch to the new node.
-                m_finish.set_node(m_finish.m_node + 1);
-                m_finish.m_curr = m_finish.m_first;
-            }
-            catch (const std::exception) {
-                deallocate_node(*(m_finish.m_node + 1));
-                throw;
-            }
-        }
-
-        void push_front_aux(const value_type& value) {
+        template <typename... Args>
+        void push_front_aux(Args&&... args) {
             // Allocate a new node at the front.
             reserve_map_at_front();
             *(m_start.m_node - 1) = allocate_node();
@@ -403,7 +464,7 @@ namespace TinySTL {
                 m_start.set_node(m_start.m_node - 1);
                 m_start.m_curr = m_start.m_last - 1;
                 // Construct the new element at the beginning of the new node.
-                construct(m_start.m_curr, value);
+                construct(m_start.m_curr, std::forward<Args>(args)...);
             }
             catch (const std::exception&) {
                 ++m_start;
@@ -412,24 +473,6 @@ namespace TinySTL {
             }
         }
 
-        void push_front_aux() {
-            // Allocate a new node at the front.
-            reserve_map_at_front();
-            *(m_start.m_node - 1) = allocate_node();
-            try {
-                // Switch to the new node.
-                m_start.set_node(m_start.m_node - 1);
-                m_start.m_curr = m_start.m_last - 1;
-                // Construct the new element at the beginning of the new node.
-                construct(m_start.m_curr);
-            }
-            catch (const std::exception) {
-                ++m_start;
-                deallocate_node(*(m_start.m_node - 1));
-                throw;
-            }
-        }
-
         void pop_back_aux() {
             // Destroy the last element which is located at the beginning of the last node.
             deallocate_node(m_finish.m_first);
@@ -452,25 +495,28 @@ namespace TinySTL {
             m_start.m_curr = m_start.m_first;
         }
 
-        iterator insert_aux(iterator pos, const value_type& value) {
+        template <typename... Args>
+        iterator emplace_aux(iterator pos, Args&&... args) {
+            // Construct the value first, since `args` may refer to an element of this deque.
+            value_type value(std::forward<Args>(args)...);
             const difference_type index = pos - m_start;
             // If in the first half.
             if (index < (difference_type)(size() / 2)) {
-                push_front(front());
+                push_front(std::move(front()));
                 // Map may be extended and changed memory position,
                 // here we need to insert after `pos`.
                 pos = m_start + index;
-                // Copy [`m_start + 2`, `pos + 1`) to [`m_start + 1`, `pos`).
-                copy(m_start + 2, pos + 1, m_start + 1);
+                // Move [`m_start + 2`, `pos + 1`) to [`m_start + 1`, `pos`).
+                TinySTL::move(m_start + 2, pos + 1, m_start + 1);
             }
             // If in the second half.
             else {
-                push_back(back());
+                push_back(std::move(back()));
                 pos = m_start + index;
-                // Copy [`pos`, `m_finish - 2`) to [`pos + 1`, `m_finish - 1`).
-                copy_backward(pos, m_finish - 2, m_finish - 1);
+                // Move [`pos`, `m_finish - 2`) to [`pos + 1`, `m_finish - 1`).
+                TinySTL::move_backward(pos, m_finish - 2, m_finish - 1);
             }
-            *pos = value;
+            *pos = std::move(value);
             return pos;
         }
 
@@ -480,23 +526,25 @@ namespace TinySTL {
             if (index < (difference_type)(size() / 2)) {
                 iterator new_start = reserve_element_at_front(n);
                 iterator old_start = m_start;
+                // The map may be reallocated.
+                pos = m_start + index;
                 try {
                     if (index < difference_type(n)) {
                         // Copy [`old_start`, `pos`) to [`new_start`, `new_start + index`).
-                        iterator new_index = uninitialized_copy(old_start, pos, new_start);
+                        iterator new_index = TinySTL::uninitialized_copy(old_start, pos, new_start);
                         // Fill [`new_start + index`, `old_start`) with value.
-                        uninitialized_fill(new_index, old_start, value);
+                        TinySTL::uninitialized_fill(new_index, old_start, value);
                         // Fill [`old_start`, `pos`) with value.
-                        fill(old_start, pos, value);
+                        TinySTL::fill(old_start, pos, value);
                     }
                     else {
                         // Copy [`old_start`, `old_start + n`) to [`new_start`, `new_start + n`).
                         iterator start_n = old_start + difference_type(n);
-                        uninitialized_copy(old_start, start_n, new_start);
+                        TinySTL::uninitialized_copy(old_start, start_n, new_start);
                         // Copy [`old_start + n`, `pos`) to [`new_start + n`, `new_start + index`).
-                        copy(start_n, pos, old_start);
+                        TinySTL::copy(start_n, pos, old_start);
                         // Fill [`new_start + index`, `new_start + index + n`) with `value`.
-                        fill(pos - difference_type(n), pos, value);
+                        TinySTL::fill(pos - difference_type(n), pos, value);
                     }
                     m_start = new_start;
                 }
@@ -516,20 +564,20 @@ namespace TinySTL {
                     if (element_after <= difference_type(n)) {
                         // Copy [`pos`, `old_finish`) to [`pos + n`, `new_finish`).
                         iterator pos_n = pos + difference_type(n);
-                        uninitialized_copy(pos, m_finish, pos_n);
+                        TinySTL::uninitialized_copy(pos, m_finish, pos_n);
                         // Fill [`old_finish`, `pos + n`) with `value`.
-                        uninitialized_fill(m_finish, pos_n, value);
+                        TinySTL::uninitialized_fill(m_finish, pos_n, value);
                         // Fill [`pos`, `old_finish`) with `value`.
-                        fill(pos, m_finish, value);
+                        TinySTL::fill(pos, m_finish, value);
                     }
                     else {
                         // Copy [`old_finish - n`, `old_finish`) to [`old_finish`, `old_finish + n`).
                         iterator finish_n = old_finish - difference_type(n);
-                        uninitialized_copy(finish_n, old_finish, old_finish);
+                        TinySTL::uninitialized_copy(finish_n, old_finish, old_finish);
                         // Copy [`pos`, `old_finish - n`) to [`pos + n`, `old_finish`).
-                        copy_backward(pos, finish_n, old_finish);
+                        TinySTL::copy_backward(pos, finish_n, old_finish);
                         // Fill [`pos`, `pos + n`) with `value`.
-                        fill(pos, pos + difference_type(n), value);
+                        TinySTL::fill(pos, pos + difference_type(n), value);
                     }
                     m_finish = new_finish;
                 }
@@ -540,29 +588,33 @@ namespace TinySTL {
             }
         }
 
-        void insert_aux(iterator pos, const value_type* first, const value_type* last, size_type n) {
+        template <typename ForwardIterator>
+        void insert_aux(iterator pos, ForwardIterator first, ForwardIterator last, size_type n) {
             const difference_type index = pos - m_start;
             if (index < (difference_type)(size() / 2)) {
                 iterator new_start = reserve_element_at_front(n);
                 iterator old_start = m_start;
+                // The map may be reallocated.
+                pos = m_start + index;
                 try {
                     if (index < difference_type(n)) {
                         // Copy [`old_start`, `pos`) to [`new_start`, `new_start + index`).
-                        const value_type* mid = first + (difference_type(n) - index);
-                        uninitialized_copy(old_start, pos, new_start);
+                        ForwardIterator mid = first;
+                        TinySTL::advance(mid, difference_type(n) - index);
+                        TinySTL::uninitialized_copy(old_start, pos, new_start);
                         // Copy [`first`, `first + n - index`) to [`old_start`, `pos`).
-                        uninitialized_copy(first, mid, pos - difference_type(n));
+                        TinySTL::uninitialized_copy(first, mid, pos - difference_type(n));
                         // Copy [`first + n - index`, `last`) to [`new_start + index`, `old_start`).
-                        copy(mid, last, old_start);
+                        TinySTL::copy(mid, last, old_start);
                     }
                     else {
                         // Copy [`old_start`, `old_start + n`) to [`new_start`, `new_start + n`).
                         iterator start_n = old_start + difference_type(n);
-                        uninitialized_copy(old_start, start_n, new_start);
+                        TinySTL::uninitialized_copy(old_start, start_n, new_start);
                         // Copy [`old_start + n`, `pos`) to [`new_start + n`, `new_start + index`).
-                        copy(start_n, pos, old_start);
+                        TinySTL::copy(start_n, pos, old_start);
                         // Copy [`first`, `last`) to [`pos - n`, `pos`).
-                        copy(first, last, pos - difference_type(n));
+                        TinySTL::copy(first, last, pos - difference_type(n));
                     }
                     m_start = new_start;
                 }
@@ -575,24 +627,27 @@ namespace TinySTL {
                 const difference_type element_after = m_finish - pos;
                 iterator new_finish                 = reserve_element_at_back(n);
                 iterator old_finish                 = m_finish;
+
+                pos = old_finish - element_after;
                 try {
                     if (element_after <= difference_type(n)) {
                         // Copy [`pos`, `old_finish`) to [`pos + n`, `new_finish`).
-                        const value_type* mid = first + element_after;
-                        uninitialized_copy(pos, old_finish, pos + difference_type(n));
+                        ForwardIterator mid = first;
+                        TinySTL::advance(mid, element_after);
+                        TinySTL::uninitialized_copy(pos, old_finish, pos + difference_type(n));
                         // Copy [`mid`, `last`) to [`old_finish`, `pos + n`).
-                        uninitialized_copy(mid, last, old_finish);
+                        TinySTL::uninitialized_copy(mid, last, old_finish);
                         // Copy [`first`, `mid`) to [`pos`, `old_finish`).
-                        copy(first, mid, pos);
+                        TinySTL::copy(first, mid, pos);
                     }
                     else {
                         // Copy [`old_finish - n`, `old_finish`) to [`old_finish`, `old_finish + n`).
                         iterator finish_n = old_finish - difference_type(n);
-                        uninitialized_copy(finish_n, old_finish, old_finish);
+                        TinySTL::uninitialized_copy(finish_n, old_finish, old_finish);
                         // Copy [`pos`, `old_finish - n`) to [`pos + n`, `old_finish`).
-                        copy_backward(pos, finish_n, old_finish);
+                        TinySTL::copy_backward(pos, finish_n, old_finish);
                         // Copy [`first`, `last`) to [`pos`, `pos + n`).
-                        copy(first, last, pos);
+                        TinySTL::copy(first, last, pos);
                     }
                     m_finish = new_finish;
                 }
@@ -603,103 +658,226 @@ namespace TinySTL {
             }
         }
 
-        void insert_aux(iterator pos, const_iterator first, const_iterator last, size_type n) {
-            const difference_type index = pos - m_start;
-            if (index < (difference_type)(size() / 2)) {
-                iterator new_start = reserve_element_at_front(n);
-                iterator old_start = m_start;
-                try {
-                    if (index < difference_type(n)) {
-                        const value_type* mid = first + (difference_type(n) - index);
-                        uninitialized_copy(old_start, pos, new_start);
-                        uninitialized_copy(first, mid, pos - difference_type(n));
-                        copy(mid, last, old_start);
-                    }
-                    else {
-                        iterator start_n = old_start + difference_type(n);
-                        uninitialized_copy(old_start, start_n, new_start);
-                        copy(start_n, pos, old_start);
-                        copy(first, last, pos - difference_type(n));
-                    }
-                    m_start = new_start;
+        /// @brief: Copy construct `n` elements from `first` into the reserved space at `result`,
+        /// with one `uninitialized_copy` per buffer, so that trivial elements are copied by `memmove`.
+        template <typename ForwardIterator>
+        iterator copy_to_buffers(ForwardIterator first, size_type n, iterator result) {
+            iterator start = result;
+            try {
+                while (n > 0) {
+                    const size_type len = TinySTL::min(n, (size_type)(result.m_last - result.m_curr));
+                    ForwardIterator mid = first;
+                    TinySTL::advance(mid, len);
+                    TinySTL::uninitialized_copy(first, mid, result.m_curr);
+                    first = mid;
+                    result += difference_type(len);
+                    n -= len;
                 }
-                catch (const std::exception& e) {
-                    destroy_nodes(new_start.m_node, old_start.m_node);
-                    throw;
+            }
+            catch (const std::exception&) {
+                destory(start, result);
+                throw;
+            }
+            return result;
+        }
+
+        template <typename Integer>
+        void initialize_dispatch(Integer n, Integer value, __true_type) {
+            initialize_map((size_type)n);
+            fill_initialize((value_type)value);
+        }
+
+        template <typename InputIterator>
+        void initialize_dispatch(InputIterator first, InputIterator last, __false_type) {
+            range_initialize(first, last, iterator_category(first));
+        }
+
+        template <typename InputIterator>
+        void range_initialize(InputIterator first, InputIterator last, input_iterator_tag) {
+            initialize_map(0);
+            try {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
                 }
             }
+            catch (const std::exception&) {
+                clear();
+                deallocate_node(m_start.m_first);
+                release_spare_nodes();
+                deallocate_map(m_map, m_map_size);
+                throw;
+            }
+        }
+
+        template <typename ForwardIterator>
+        void range_initialize(ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+            const size_type n = TinySTL::distance(first, last);
+            initialize_map(n);
+            try {
+                copy_to_buffers(first, n, m_start);
+            }
+            catch (const std::exception&) {
+                destroy_nodes(m_start.m_node, m_finish.m_node + 1);
+                release_spare_nodes();
+                deallocate_map(m_map, m_map_size);
+                throw;
+            }
+        }
+
+        template <typename Integer>
+        void insert_dispatch(iterator pos, Integer n, Integer value, __true_type) {
+            insert(pos, (size_type)n, (value_type)value);
+        }
+
+        template <typename InputIterator>
+        void insert_dispatch(iterator pos, InputIterator first, InputIterator last, __false_type) {
+            range_insert(pos, first, last, iterator_category(first));
+        }
+
+        template <typename InputIterator>
+        void range_insert(iterator pos, InputIterator first, InputIterator last, input_iterator_tag) {
+            if (pos == m_start) {
+                prepend(first, last);
+            }
+            else if (pos == m_finish) {
+                append(first, last);
+            }
+            // Collect the elements first, then insert them as a forward range.
             else {
-                const difference_type element_after = m_finish - pos;
-                iterator new_finish                 = reserve_element_at_back(n);
-                iterator old_finish                 = m_finish;
+                deque temp(get_allocator());
+                temp.append(first, last);
+                insert_aux(pos, temp.begin(), temp.end(), temp.size());
+            }
+        }
 
-                pos = old_finish - element_after;
-                try {
-                    if (element_after <= difference_type(n)) {
-                        const value_type* mid = first + element_after;
-                        uninitialized_copy(pos, old_finish, pos + difference_type(n));
-                        uninitialized_copy(mid, last, old_finish);
-                        copy(first, mid, pos);
-                    }
-                    else {
-                        iterator finish_n = old_finish - difference_type(n);
-                        uninitialized_copy(finish_n, old_finish, old_finish);
-                        copy_backward(pos, finish_n, old_finish);
-                        copy(first, last, pos);
-                    }
-                    m_finish = new_finish;
-                }
-                catch (const std::exception& e) {
-                    destroy_nodes(old_finish.m_node + 1, new_finish.m_node + 1);
-                    throw;
-                }
+        template <typename ForwardIterator>
+        void range_insert(iterator pos, ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+            if (pos == m_start) {
+                prepend(first, last);
+            }
+            else if (pos == m_finish) {
+                append(first, last);
+            }
+            else {
+                insert_aux(pos, first, last, TinySTL::distance(first, last));
+            }
+        }
+
+        template <typename InputIterator>
+        void append_aux(InputIterator first, InputIterator last, input_iterator_tag) {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+
+        template <typename ForwardIterator>
+        void append_aux(ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+            const size_type n   = TinySTL::distance(first, last);
+            iterator new_finish = reserve_element_at_back(n);
+            try {
+                copy_to_buffers(first, n, m_finish);
+            }
+            catch (const std::exception&) {
+                destroy_nodes(m_finish.m_node + 1, new_finish.m_node + 1);
+                throw;
             }
+            m_finish = new_finish;
+        }
+
+        template <typename InputIterator>
+        void prepend_aux(InputIterator first, InputIterator last, input_iterator_tag) {
+            // The length is unknown, collect the elements first.
+            deque temp(get_allocator());
+            temp.append(first, last);
+            prepend_aux(temp.begin(), temp.end(), forward_iterator_tag());
+        }
+
+        template <typename ForwardIterator>
+        void prepend_aux(ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+            const size_type n  = TinySTL::distance(first, last);
+            iterator new_start = reserve_element_at_front(n);
+            try {
+                copy_to_buffers(first, n, new_start);
+            }
+            catch (const std::exception&) {
+                destroy_nodes(new_start.m_node, m_start.m_node);
+                throw;
+            }
+            m_start = new_start;
         }
 
     public:
         deque() { initialize_map(0); }
 
-        explicit deque(size_t n, const value_type& value = value_type()) {
+        explicit deque(const Alloc& a)
+            : node_allocator(a)
+            , map_allocator(a) {
+            initialize_map(0);
+        }
+
+        explicit deque(size_t n, const value_type& value = value_type(), const Alloc& a = Alloc())
+            : node_allocator(a)
+            , map_allocator(a) {
             initialize_map(n);
             fill_initialize(value);
         }
 
-        deque(const deque& other) {
-            initialize_map(other.size());
-            TinySTL::uninitialized_copy(other.begin(), other.end(), begin());
+        deque(const deque& other)
+            : node_allocator(other.get_allocator())
+            , map_allocator(other.get_allocator()) {
+            range_initialize(other.begin(), other.end(), random_access_iterator_tag());
         }
 
-        deque(const value_type* first, const value_type* last) {
-            initialize_map(last - first);
-            TinySTL::uninitialized_copy(first, last, begin());
+        deque(deque&& other)
+            : node_allocator(other.get_allocator())
+            , map_allocator(other.get_allocator()) {
+            // Leave `other` empty but valid.
+            initialize_map(0);
+            swap(*this, other);
         }
 
-        deque(const_iterator first, const_iterator last) {
-            initialize_map(last - first);
-            TinySTL::uninitialized_copy(first, last, begin());
+        /// @brief Construct from [`first`, `last`), or `first` copies of `last` if they are integers.
+        template <typename InputIterator>
+        deque(InputIterator first, InputIterator last, const Alloc& a = Alloc())
+            : node_allocator(a)
+            , map_allocator(a) {
+            using integral = typename __is_integer<InputIterator>::integral;
+            initialize_dispatch(first, last, integral());
         }
 
         deque& operator=(const deque& other) {
             if (this != &other) {
                 const size_type len = size();
                 if (len >= other.size()) {
-                    iterator new_finish = copy(other.begin(), other.end(), begin());
+                    iterator new_finish = TinySTL::copy(other.begin(), other.end(), begin());
                     erase(new_finish, m_finish);
                 }
                 else {
                     const_iterator mid = other.begin() + difference_type(len);
-                    copy(other.begin(), mid, begin());
+                    TinySTL::copy(other.begin(), mid, begin());
                     insert(m_finish, mid, other.end());
                 }
             }
             return *this;
         }
 
+        deque& operator=(deque&& other) noexcept {
+            if (this != &other) {
+                swap(*this, other);
+            }
+            return *this;
+        }
+
         ~deque() {
             clear();
+            // `clear` keeps one buffer.
+            deallocate_node(m_start.m_first);
+            release_spare_nodes();
             deallocate_map(m_map, m_map_size);
         }
 
+        allocator_type get_allocator() const { return node_allocator::get_allocator(); }
+
         iterator begin() { return m_start; }
         iterator end() { return m_finish; }
         const_iterator begin() const { return m_start; }
@@ -728,15 +906,26 @@ namespace TinySTL {
             }
         }
 
+        void push_back(value_type&& value) {
+            emplace_back(std::move(value));
+        }
+
         void push_back() {
+            emplace_back();
+        }
+
+        /// @brief Construct a value from `args` at the back of the deque.
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
             // If not at the last - 1 position of current buffer.
             if (m_finish.m_curr != m_finish.m_last - 1) {
-                construct(m_finish.m_curr);
+                construct(m_finish.m_curr, std::forward<Args>(args)...);
                 ++m_finish.m_curr;
             }
             else {
-                push_back_aux();
+                push_back_aux(std::forward<Args>(args)...);
             }
+            return back();
         }
 
         void push_front(const value_type& value) {
@@ -750,15 +939,26 @@ namespace TinySTL {
             }
         }
 
+        void push_front(value_type&& value) {
+            emplace_front(std::move(value));
+        }
+
         void push_front() {
+            emplace_front();
+        }
+
+        /// @brief Construct a value from `args` at the front of the deque.
+        template <typename... Args>
+        reference emplace_front(Args&&... args) {
             // If not at the first position of current buffer.
             if (m_start.m_curr != m_start.m_first) {
-                construct(m_start.m_curr - 1);
+                construct(m_start.m_curr - 1, std::forward<Args>(args)...);
                 --m_start.m_curr;
             }
             else {
-                push_front_aux();
+                push_front_aux(std::forward<Args>(args)...);
             }
+            return front();
         }
 
         void pop_back() {
@@ -797,86 +997,66 @@ namespace TinySTL {
             }
             // Insert in the middle.
             else {
-                return insert_aux(pos, value);
+                return emplace_aux(pos, value);
             }
         }
 
-        void insert(iterator pos, size_type n, const value_type& value = value_type()) {
-            // If insert at the front, move the m_start.
+        iterator insert(iterator pos, value_type&& value) {
+            return emplace(pos, std::move(value));
+        }
+
+        /// @brief Construct a value from `args` at the front of the `pos`.
+        template <typename... Args>
+        iterator emplace(iterator pos, Args&&... args) {
             if (pos.m_curr == m_start.m_curr) {
-                iterator new_start = reserve_element_at_front(n);
-                uninitialized_fill(new_start, m_start, value);
-                m_start = new_start;
+                emplace_front(std::forward<Args>(args)...);
+                return m_start;
             }
-            // If insert at the back, move the m_finish.
             else if (pos.m_curr == m_finish.m_curr) {
-                iterator new_finish = reserve_element_at_back(n);
-                uninitialized_fill(m_finish, new_finish, value);
-                m_finish = new_finish;
+                emplace_back(std::forward<Args>(args)...);
+                return m_finish - 1;
             }
             else {
-                insert_aux(pos, n, value);
+                return emplace_aux(pos, std::forward<Args>(args)...);
             }
         }
 
-        void insert(iterator pos, const value_type* first, const value_type* last) {
-            size_type n = last - first;
+        void insert(iterator pos, size_type n, const value_type& value = value_type()) {
             // If insert at the front, move the m_start.
             if (pos.m_curr == m_start.m_curr) {
                 iterator new_start = reserve_element_at_front(n);
-                try {
-                    uninitialized_copy(first, last, new_start);
-                    m_start = new_start;
-                }
-                catch (const std::exception&) {
-                    destroy_nodes(new_start.m_node, m_start.m_node);
-                    throw;
-                }
+                TinySTL::uninitialized_fill(new_start, m_start, value);
+                m_start = new_start;
             }
             // If insert at the back, move the m_finish.
             else if (pos.m_curr == m_finish.m_curr) {
                 iterator new_finish = reserve_element_at_back(n);
-                try {
-                    uninitialized_copy(first, last, m_finish);
-                    m_finish = new_finish;
-                }
-                catch (const std::exception&) {
-                    destroy_nodes(m_finish.m_node + 1, new_finish.m_node + 1);
-                    throw;
-                }
+                TinySTL::uninitialized_fill(m_finish, new_finish, value);
+                m_finish = new_finish;
             }
             else {
-                insert_aux(pos, first, last, n);
+                insert_aux(pos, n, value);
             }
         }
 
-        void insert(iterator pos, const_iterator first, const_iterator last) {
-            size_type n = last - first;
-            if (pos.m_curr == m_start.m_curr) {
-                iterator new_start = reserve_element_at_front(n);
-                try {
-                    uninitialized_copy(first, last, new_start);
-                    m_start = new_start;
-                }
-                catch (const std::exception& e) {
-                    destroy_nodes(new_start.m_node, m_start.m_node);
-                    throw;
-                }
-            }
-            else if (pos.m_curr == m_finish.m_curr) {
-                iterator new_finish = reserve_element_at_back(n);
-                try {
-                    uninitialized_copy(first, last, m_finish);
-                    m_finish = new_finish;
-                }
-                catch (const std::exception& e) {
-                    destroy_nodes(m_finish.m_node + 1, new_finish.m_node + 1);
-                    throw;
-                }
-            }
-            else {
-                insert_aux(pos, first, last, n);
-            }
+        /// @brief Insert [`first`, `last`), or `first` copies of `last` if they are integers.
+        template <typename InputIterator>
+        void insert(iterator pos, InputIterator first, InputIterator last) {
+            using integral = typename __is_integer<InputIterator>::integral;
+            insert_dispatch(pos, first, last, integral());
+        }
+
+        /// @brief Append [`first`, `last`) at the back.
+        /// A forward range reserves all the buffers first and fills each with one `uninitialized_copy`.
+        template <typename InputIterator>
+        void append(InputIterator first, InputIterator last) {
+            append_aux(first, last, iterator_category(first));
+        }
+
+        /// @brief Insert [`first`, `last`) at the front, in their order.
+        template <typename InputIterator>
+        void prepend(InputIterator first, InputIterator last) {
+            prepend_aux(first, last, iterator_category(first));
         }
 
         iterator erase(iterator pos) {
@@ -885,18 +1065,22 @@ namespace TinySTL {
             difference_type index = pos - m_start;
             // At the first half.
             if (index < (difference_type)(size() / 2)) {
-                copy_backward(m_start, pos, next);
+                TinySTL::move_backward(m_start, pos, next);
                 pop_front();
             }
             // At the second half.
             else {
-                copy(next, m_finish, pos);
+                TinySTL::move(next, m_finish, pos);
                 pop_back();
             }
             return m_start + index;
         }
 
         iterator erase(iterator first, iterator last) {
+            // Moving the shorter side onto itself may empty the elements.
+            if (first == last) {
+                return first;
+            }
             // If erase all.
             if (first == m_start && last == m_finish) {
                 clear();
@@ -907,7 +1091,7 @@ namespace TinySTL {
             difference_type index = first - m_start;
             if (index < (difference_type)((size() - n) / 2)) {
                 // Move [`m_start`, `first`) to [`m_start + n`, `last`).
-                copy_backward(m_start, first, last);
+                TinySTL::move_backward(m_start, first, last);
                 iterator new_start = m_start + n;
                 destory(m_start, new_start);
                 destroy_nodes(m_start.m_node, new_start.m_node);
@@ -915,7 +1099,7 @@ namespace TinySTL {
             }
             else {
                 // Move [`last`, `m_finish`) to [`first`, `m_finish - n`).
-                copy(last, m_finish, first);
+                TinySTL::move(last, m_finish, first);
                 iterator new_finish = m_finish - n;
                 destory(new_finish, m_finish);
                 destroy_nodes(new_finish.m_node + 1, m_finish.m_node + 1);
@@ -934,10 +1118,15 @@ namespace TinySTL {
             }
         }
 
+        /// @brief Give back the spare buffers.
+        void shrink_to_fit() {
+            release_spare_nodes();
+        }
+
         void clear() {
             // Destroy the elements in the middle.
             for (map_pointer curr_node = m_start.m_node + 1; curr_node < m_finish.m_node; ++curr_node) {
-                destory(*curr_node, *curr_node + deque_buffer_size(BufSize, sizeof(T)));
+                destory(*curr_node, *curr_node + buffer_size());
                 deallocate_node(*curr_node);
             }
 
@@ -954,35 +1143,38 @@ namespace TinySTL {
             m_finish = m_start;
         }
 
-        friend void swap(deque& lhs, deque& rhs) {
-            using std::swap;
-            swap(m_start, other.m_start);
-            swap(m_finish, other.m_finish);
-            swap(m_map, other.m_map);
-            swap(m_map_size, other.m_map_size);
+        friend void swap(deque& lhs, deque& rhs) noexcept {
+            TinySTL::swap(static_cast<node_allocator&>(lhs), static_cast<node_allocator&>(rhs));
+            TinySTL::swap(static_cast<map_allocator&>(lhs), static_cast<map_allocator&>(rhs));
+            TinySTL::swap(lhs.m_start, rhs.m_start);
+            TinySTL::swap(lhs.m_finish, rhs.m_finish);
+            TinySTL::swap(lhs.m_map, rhs.m_map);
+            TinySTL::swap(lhs.m_map_size, rhs.m_map_size);
+            TinySTL::swap_ranges(lhs.m_spare, lhs.m_spare + _SPARE, rhs.m_spare);
+            TinySTL::swap(lhs.m_spare_count, rhs.m_spare_count);
         }
 
-        friend bool operator==(const vector& lhs, const vector& rhs) noexcept {
+        friend bool operator==(const deque& lhs, const deque& rhs) noexcept {
             return lhs.size() == rhs.size() && TinySTL::equal(lhs.begin(), lhs.end(), rhs.begin());
         }
 
-        friend bool operator!=(const vector& lhs, const vector& rhs) noexcept {
+        friend bool operator!=(const deque& lhs, const deque& rhs) noexcept {
             return !(lhs == rhs);
         }
 
-        friend bool operator<(const vector& lhs, const vector& rhs) noexcept {
-            return lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        friend bool operator<(const deque& lhs, const deque& rhs) noexcept {
+            return TinySTL::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
         }
 
-        friend bool operator>(const vector& lhs, const vector& rhs) noexcept {
+        friend bool operator>(const deque& lhs, const deque& rhs) noexcept {
             return rhs < lhs;
         }
 
-        friend bool operator<=(const vector& lhs, const vector& rhs) noexcept {
+        friend bool operator<=(const deque& lhs, const deque& rhs) noexcept {
             return !(rhs < lhs);
         }
 
-        friend bool operator>=(const vector& lhs, const vector& rhs) noexcept {
+        friend bool operator>=(const deque& lhs, const deque& rhs) noexcept {
             return !(lhs < rhs);
         }
     };
@@ -1,7 +1,9 @@
 #ifndef _TINYSTL_FORWARD_LIST_HPP_
 #define _TINYSTL_FORWARD_LIST_HPP_
 
+#include <stl_algorithm.hpp>
 #include <stl_allocator.hpp>
+#include <stl_function.hpp>
 #include <stl_iterator.hpp>
 #include <stl_uninitialized.hpp>
 
@@ -66,6 +68,74 @@ namespace TinySTL {
         return result;
     }
 
+    // Merge the sorted list after `other` into the sorted list after `head`, `comp` compares two nodes.
+    // Equal nodes of `head` go first.
+    template <typename Compare>
+    void forward_list_merge(forward_list_node_base* head, forward_list_node_base* other, Compare& comp) {
+        forward_list_node_base* curr = head;
+        while (curr->next && other->next) {
+            if (comp(other->next, curr->next)) {
+                forward_list_splice_after(curr, other, other->next);
+            }
+            curr = curr->next;
+        }
+        // Other list is longer.
+        if (other->next) {
+            curr->next  = other->next;
+            other->next = nullptr;
+        }
+    }
+
+    // Merge two sorted chains ended with `nullptr`, the nodes of `a` go first among the equal ones.
+    template <typename Compare>
+    forward_list_node_base* forward_list_merge_chain(forward_list_node_base* a, forward_list_node_base* b, Compare& comp) {
+        forward_list_node_base result;
+        forward_list_node_base* tail = &result;
+        while (a != nullptr && b != nullptr) {
+            if (comp(b, a)) {
+                tail->next = b;
+                tail       = b;
+                b          = b->next;
+            }
+            else {
+                tail->next = a;
+                tail       = a;
+                a          = a->next;
+            }
+        }
+        tail->next = a != nullptr ? a : b;
+        return result.next;
+    }
+
+    // Bottom-up merge sort of a chain ended with `nullptr`, like `list_sort_chain`.
+    template <typename Compare>
+    forward_list_node_base* forward_list_sort_chain(forward_list_node_base* first, Compare& comp) {
+        forward_list_node_base* bins[64] = {};
+        int fill                         = 0;
+        while (first != nullptr) {
+            forward_list_node_base* carry = first;
+            first                         = first->next;
+            carry->next                   = nullptr;
+            int i                         = 0;
+            for (; i < fill && bins[i] != nullptr; ++i) {
+                carry   = forward_list_merge_chain(bins[i], carry, comp);
+                bins[i] = nullptr;
+            }
+            bins[i] = carry;
+            if (i == fill) {
+                ++fill;
+            }
+        }
+        // The higher bins hold the earlier nodes.
+        forward_list_node_base* result = nullptr;
+        for (int i = 0; i < fill; ++i) {
+            if (bins[i] != nullptr) {
+                result = result == nullptr ? bins[i] : forward_list_merge_chain(bins[i], result, comp);
+            }
+        }
+        return result;
+    }
+
     template <typename T>
     struct forward_list_node : public forward_list_node_base {
         T data;
@@ -135,7 +205,7 @@ namespace TinySTL {
     }
 
     template <typename T, typename Alloc = alloc>
-    class forward_list {
+    class forward_list : private simple_alloc<forward_list_node<T>, Alloc> {
     public:
         using value_type      = T;
         using pointer         = T*;
@@ -149,6 +219,7 @@ namespace TinySTL {
         using const_iterator = forward_list_iterator<T, const T&, const T*>;
 
         using forward_list_allocator = simple_alloc<forward_list_node<T>, Alloc>;
+        using allocator_type         = Alloc;
 
     private:
         using list_node      = forward_list_node<T>;
@@ -182,6 +253,7 @@ namespace TinySTL {
                 put_node(node);
                 throw;
             }
+            return node;
         }
 
         void destory_node(list_node* node) {
@@ -191,26 +263,37 @@ namespace TinySTL {
 
     private:
         list_node_base m_head;
+        // Number of elements, kept by every operation that links or unlinks nodes.
+        size_type m_size = 0;
 
     public:
         forward_list() { m_head.next = nullptr; }
 
-        explicit forward_list(size_type n, const value_type& value = value_type()) {
+        explicit forward_list(const Alloc& a)
+            : forward_list_allocator(a) {
+            m_head.next = nullptr;
+        }
+
+        explicit forward_list(size_type n, const value_type& value = value_type(), const Alloc& a = Alloc())
+            : forward_list_allocator(a) {
             m_head.next = nullptr;
             insert_after_fill(&m_head, n, value);
         }
 
-        forward_list(const value_type* first, const value_type* last) {
+        forward_list(const value_type* first, const value_type* last, const Alloc& a = Alloc())
+            : forward_list_allocator(a) {
             m_head.next = nullptr;
             insert_after_range(&m_head, first, last);
         }
 
-        forward_list(const_iterator first, const_iterator last) {
+        forward_list(const_iterator first, const_iterator last, const Alloc& a = Alloc())
+            : forward_list_allocator(a) {
             m_head.next = nullptr;
             insert_after_range(&m_head, first, last);
         }
 
-        forward_list(const forward_list& other) {
+        forward_list(const forward_list& other)
+            : forward_list_allocator(other.get_allocator()) {
             m_head.next = nullptr;
             insert_after_range(&m_head, other.begin(), other.end());
         }
@@ -231,7 +314,7 @@ namespace TinySTL {
                     erase_after_aux(last, nullptr);
                 }
                 else {
-                    insert_after_range(last, const_iterator(other_curr), const_iterator(nullptr));
+                    insert_after_range(last, const_iterator((list_node*)other_curr), const_iterator(nullptr));
                 }
             }
             return *this;
@@ -241,11 +324,15 @@ namespace TinySTL {
 
     private:
         list_node* insert_after_aux(list_node_base* pos, const value_type& value) {
-            return (list_node*)forward_list_make_link(pos, create_node(value));
+            list_node* node = (list_node*)forward_list_make_link(pos, create_node(value));
+            ++m_size;
+            return node;
         }
 
         list_node* insert_after_aux(list_node_base* pos) {
-            return (list_node*)forward_list_make_link(pos, create_node());
+            list_node* node = (list_node*)forward_list_make_link(pos, create_node());
+            ++m_size;
+            return node;
         }
 
         void insert_after_fill(list_node_base* pos, size_type n, const value_type& value) {
@@ -271,17 +358,29 @@ namespace TinySTL {
             list_node_base* next_next = next->next;
             pos->next                 = next_next;
             destory_node(next);
+            --m_size;
             return next_next;
         }
 
         list_node_base* erase_after_aux(list_node_base* before_first, list_node_base* last) {
-            while (before_first->next != last) {
-                erase_after_aux(before_first);
+            // Give all the nodes back to the allocator at once.
+            __node_chain<list_node> chain;
+            list_node* curr = (list_node*)before_first->next;
+            while (curr != last) {
+                list_node* temp = curr;
+                curr            = (list_node*)curr->next;
+                destory(&temp->data);
+                chain.push(temp);
+                --m_size;
             }
+            before_first->next = last;
+            forward_list_allocator::deallocate_chain(chain);
             return last;
         }
 
     public:
+        allocator_type get_allocator() const { return forward_list_allocator::get_allocator(); }
+
         iterator begin() { return iterator((list_node*)m_head.next); }
         iterator end() { return iterator(nullptr); }
         const_iterator begin() const { return const_iterator((list_node*)m_head.next); }
@@ -289,7 +388,7 @@ namespace TinySTL {
         const_iterator cbegin() const { return const_iterator((list_node*)m_head.next); }
         const_iterator cend() const { return const_iterator(nullptr); }
 
-        size_type size() const { return forward_list_size(m_head.next); }
+        size_type size() const { return m_size; }
         bool empty() const { return m_head.next == nullptr; }
 
         reference front() { return ((list_node*)m_head.next)->data; }
@@ -304,21 +403,21 @@ namespace TinySTL {
 
         friend void swap(forward_list& lhs, forward_list& rhs) {
             using TinySTL::swap;
+            swap(static_cast<forward_list_allocator&>(lhs), static_cast<forward_list_allocator&>(rhs));
             swap(lhs.m_head.next, rhs.m_head.next);
+            swap(lhs.m_size, rhs.m_size);
         }
 
         void push_front(const value_type& value) {
-            forward_list_make_link(&m_head, create_node(value));
+            insert_after_aux(&m_head, value);
         }
 
         void push_front() {
-            forward_list_make_link(&m_head, create_node());
+            insert_after_aux(&m_head);
         }
 
         void pop_front() {
-            list_node* node = (list_node*)m_head.next;
-            m_head.next     = node->next;
-            destroy_nodes(node);
+            erase_after_aux(&m_head);
         }
 
         iterator insert_after(const_iterator pos, const value_type& value = value_type()) {
@@ -369,14 +468,34 @@ namespace TinySTL {
             return iterator((list_node*)erase_after_aux(forward_list_previous(&m_head, first.m_inner), last.m_inner));
         }
 
-        void splice_after(iterator pos, iterator before_first, iterator before_last) {
+        // Move (`before_first`, `before_last`] of `other` after `pos`.
+        // Linear in the length of the range when it comes from another list, to count it.
+        void splice_after(iterator pos, forward_list& other, iterator before_first, iterator before_last) {
+            if (before_first != before_last) {
+                size_type n = 0;
+                if (this != &other) {
+                    for (list_node_base* curr = before_first.m_inner; curr != before_last.m_inner; curr = curr->next) {
+                        ++n;
+                    }
+                }
+                splice_after(pos, other, before_first, before_last, n);
+            }
+        }
+
+        // Constant time, `n` should be the length of (`before_first`, `before_last`].
+        void splice_after(iterator pos, forward_list& other, iterator before_first, iterator before_last, size_type n) {
             if (before_first != before_last) {
                 forward_list_splice_after(pos.m_inner, before_first.m_inner, before_last.m_inner);
+                m_size       += n;
+                other.m_size -= n;
             }
         }
 
-        void splice_after(iterator pos, iterator prev) {
+        // Move the element after `prev` of `other` after `pos`.
+        void splice_after(iterator pos, forward_list& other, iterator prev) {
             forward_list_splice_after(pos.m_inner, prev.m_inner, prev.m_inner->next);
+            ++m_size;
+            --other.m_size;
         }
 
         void splice(iterator pos, forward_list& other) {
@@ -385,6 +504,8 @@ namespace TinySTL {
                     forward_list_previous(&m_head, pos.m_inner),
                     &other.m_head,
                     forward_list_previous(&other.m_head, nullptr));
+                m_size      += other.m_size;
+                other.m_size = 0;
             }
         }
 
@@ -393,6 +514,8 @@ namespace TinySTL {
                 forward_list_previous(&m_head, pos.m_inner),
                 forward_list_previous(&other.m_head, prev.m_inner),
                 prev.m_inner);
+            ++m_size;
+            --other.m_size;
         }
 
         void splice(iterator pos, iterator first, iterator last) {
@@ -400,7 +523,7 @@ namespace TinySTL {
                 forward_list_splice_after(
                     forward_list_previous(&m_head, pos.m_inner),
                     forward_list_previous(&m_head, first.m_inner),
-                    forward_list_previous(first.m_inner, last.m_inner)
+                    forward_list_previous(first.m_inner, last.m_inner));
             }
         }
 
@@ -452,53 +575,74 @@ namespace TinySTL {
             }
         }
 
-        // Other can be the same forward list.
-        void merge(forward_list& other) {
-            list_node_base* curr = &m_head;
-            while (curr->next && other.m_head.next) {
-                if (((list_node*)curr->next)->data < ((list_node*)other.m_head.next)->data) {
-                    forward_list_splice_after(curr, &other.m_head, other.m_head.next);
-                }
-                else {
-                    curr = curr->next;
-                }
-            }
-            // Other list is longer.
-            if (other.m_head.next) {
-                curr->next        = other.m_head.next;
-                other.m_head.next = nullptr;
+        // Merge two sorted list in ascending order, if the same, this list first.
+        void merge(forward_list& other) { merge(other, TinySTL::less<T>()); }
+
+        template <typename Compare>
+        void merge(forward_list& other, Compare comp) {
+            if (this == &other) {
+                return;
             }
+            __node_data_compare<list_node, Compare> node_comp(comp);
+            forward_list_merge(&m_head, &other.m_head, node_comp);
+            m_size      += other.m_size;
+            other.m_size = 0;
         }
 
-        // Similar to `list::sort`.
-        void sort() {
+        // Similar to `list::sort`, stable merge sort on the links of the nodes, it allocates nothing.
+        void sort() { sort(TinySTL::less<T>()); }
+
+        template <typename Compare>
+        void sort(Compare comp) {
             // Length <= 1 is already sorted.
-            if (m_head.next && m_head.next->next) {
-                forward_list carry;
-                forward_list counter[64];
-                int fill = 0;
-                while (!empty()) {
-                    forward_list_splice_after(&carry.m_head, &m_head, m_head.next);
-                    int i = 0;
-                    while (i < fill && !counter[i].empty()) {
-                        counter[i].merge(carry);
-                        carry.swap(counter[i++]);
-                        ++i;
-                    }
-                    carry.swap(counter[i]);
-                    if (i == fill) {
-                        ++fill;
-                    }
-                }
+            if (m_size >= 2) {
+                __node_data_compare<list_node, Compare> node_comp(comp);
+                m_head.next = forward_list_sort_chain(m_head.next, node_comp);
+            }
+        }
 
-                for (int i = 1; i < fill; ++i) {
-                    counter[i].merge(counter[i - 1]);
-                }
-                this->swap(counter[fill - 1]);
+        // Similar to `list::unstable_sort`, introsort over an array of the node pointers, the order of equal elements is not kept.
+        void unstable_sort() { unstable_sort(TinySTL::less<T>()); }
+
+        template <typename Compare>
+        void unstable_sort(Compare comp) {
+            if (m_size < _ARRAY_SORT_THRESHOLD) {
+                sort(comp);
+                return;
+            }
+            node_pointer_allocator pointer_allocator(get_allocator());
+            list_node** nodes = pointer_allocator.allocate(m_size);
+            list_node** last  = nodes;
+            for (list_node_base* curr = m_head.next; curr != nullptr; curr = curr->next) {
+                *last++ = (list_node*)curr;
             }
+            try {
+                TinySTL::sort(nodes, last, __node_data_compare<list_node, Compare>(comp));
+            }
+            catch (const std::exception&) {
+                pointer_allocator.deallocate(nodes, m_size);
+                throw;
+            }
+            // Relink the nodes in the order of the array.
+            list_node_base* prev = &m_head;
+            for (list_node** curr = nodes; curr != last; ++curr) {
+                prev->next = *curr;
+                prev       = *curr;
+            }
+            prev->next = nullptr;
+            pointer_allocator.deallocate(nodes, m_size);
         }
 
+    private:
+        enum { _ARRAY_SORT_THRESHOLD = 1 << 12 };
+
+        using node_pointer_allocator = simple_alloc<list_node*, Alloc>;
+
+    public:
         friend bool operator==(const forward_list& lhs, const forward_list& rhs) {
+            if (lhs.m_size != rhs.m_size) {
+                return false;
+            }
             list_node* curr1 = (list_node*)lhs.m_head.next;
             list_node* curr2 = (list_node*)rhs.m_head.next;
             while (curr1 && curr2 && curr1->data == curr2->data) {
@@ -513,7 +657,7 @@ namespace TinySTL {
         }
 
         friend bool operator<(const forward_list& lhs, const forward_list& rhs) {
-            return lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+            return TinySTL::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
         }
 
         friend bool operator<=(const forward_list& lhs, const forward_list& rhs) {
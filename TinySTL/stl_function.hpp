@@ -493,6 +493,19 @@ namespace TinySTL {
         return const_mem_fun1_ref_t<Return, Type, Arg>(ptr);
     }
 
+    // Compare two nodes by their data, used by the lists to merge and sort their nodes.
+    // The nodes may be given as pointers to a base of `Node` that holds the links.
+    template <typename Node, typename Compare>
+    struct __node_data_compare {
+        Compare comp;
+
+        explicit __node_data_compare(Compare c)
+            : comp(c) {}
+
+        template <typename Pointer>
+        bool operator()(Pointer lhs, Pointer rhs) { return comp(static_cast<const Node*>(lhs)->data, static_cast<const Node*>(rhs)->data); }
+    };
+
 } // namespace TinySTL
 
 #endif // !_TINYSTL_FUNCTION_HPP_
@@ -0,0 +1,606 @@
+#ifndef _TINYSTL_INTRUSIVE_LIST_HPP_
+#define _TINYSTL_INTRUSIVE_LIST_HPP_
+
+#include <cstddef>
+#include <type_traits>
+#include <stl_forward_list.hpp>
+#include <stl_function.hpp>
+#include <stl_iterator.hpp>
+#include <stl_list.hpp>
+#include <stl_type_traits.hpp>
+
+namespace TinySTL {
+
+    // Links of an object on an `intrusive_list`, a member or a base class of the object.
+    // An object has one hook for each list it can be on at the same time, at most one of them as a base.
+    // Copying an object does not copy its links, the copy is not on any list.
+    struct intrusive_list_hook {
+        intrusive_list_hook* prev;
+        intrusive_list_hook* next;
+
+        intrusive_list_hook()
+            : prev(nullptr)
+            , next(nullptr) {}
+        intrusive_list_hook(const intrusive_list_hook&)
+            : prev(nullptr)
+            , next(nullptr) {}
+        intrusive_list_hook& operator=(const intrusive_list_hook&) { return *this; }
+
+        bool is_linked() const { return next != nullptr; }
+    };
+
+    // Links of an object on an `intrusive_forward_list`, the same links as the nodes of `forward_list`.
+    struct intrusive_forward_list_hook : public forward_list_node_base {
+        intrusive_forward_list_hook() { next = nullptr; }
+        intrusive_forward_list_hook(const intrusive_forward_list_hook&) { next = nullptr; }
+        intrusive_forward_list_hook& operator=(const intrusive_forward_list_hook&) { return *this; }
+    };
+
+    // Convert between an object and its hook `Member`, by the offset of the hook in the object.
+    // A null `Member` is a base hook, `T` derives from `Hook` and the conversions are casts.
+    template <typename T, typename Hook, Hook T::*Member>
+    struct __hook_traits {
+        using is_base_hook = typename std::conditional<Member == nullptr, __true_type, __false_type>::type;
+
+        static size_t offset() { return reinterpret_cast<size_t>(&(reinterpret_cast<T*>(0)->*Member)); }
+
+        static Hook* to_hook(T& value) { return to_hook(&value, is_base_hook()); }
+        static const Hook* to_hook(const T& value) { return to_hook(const_cast<T*>(&value), is_base_hook()); }
+        static T* to_value(Hook* hook) { return to_value(hook, is_base_hook()); }
+        static const T* to_value(const Hook* hook) { return to_value(const_cast<Hook*>(hook), is_base_hook()); }
+
+        // Compare two hooks by their objects.
+        template <typename Compare>
+        struct compare {
+            Compare comp;
+
+            explicit compare(Compare c)
+                : comp(c) {}
+
+            bool operator()(const Hook* lhs, const Hook* rhs) { return comp(*to_value(lhs), *to_value(rhs)); }
+        };
+
+    private:
+        static Hook* to_hook(T* value, __true_type) { return static_cast<Hook*>(value); }
+        static Hook* to_hook(T* value, __false_type) { return &(value->*Member); }
+        static T* to_value(Hook* hook, __true_type) { return static_cast<T*>(hook); }
+        static T* to_value(Hook* hook, __false_type) { return (T*)((char*)hook - offset()); }
+    };
+
+    template <typename T, intrusive_list_hook T::*Hook, typename Ref, typename Ptr>
+    struct intrusive_list_iterator {
+        using iterator       = intrusive_list_iterator<T, Hook, T&, T*>;
+        using const_iterator = intrusive_list_iterator<T, Hook, const T&, const T*>;
+        using self           = intrusive_list_iterator<T, Hook, Ref, Ptr>;
+
+        using iterator_category = bidirectional_iterator_tag;
+        using value_type        = T;
+        using pointer           = Ptr;
+        using reference         = Ref;
+        using size_type         = size_t;
+        using difference_type   = ptrdiff_t;
+
+        using hook_traits = __hook_traits<T, intrusive_list_hook, Hook>;
+
+    public:
+        intrusive_list_hook* m_inner;
+
+        intrusive_list_iterator(intrusive_list_hook* n = nullptr)
+            : m_inner(n) {}
+        intrusive_list_iterator(const iterator& other)
+            : m_inner(other.m_inner) {}
+
+        friend bool operator==(const self& lhs, const self& rhs) noexcept { return lhs.m_inner == rhs.m_inner; }
+        friend bool operator!=(const self& lhs, const self& rhs) noexcept { return !(lhs == rhs); }
+
+        reference operator*() const { return *hook_traits::to_value(m_inner); }
+        pointer operator->() const { return &(operator*()); }
+
+        self& operator++() {
+            m_inner = m_inner->next;
+            return *this;
+        }
+        self operator++(int) {
+            self temp = *this;
+            ++*this;
+            return temp;
+        }
+        self& operator--() {
+            m_inner = m_inner->prev;
+            return *this;
+        }
+        self operator--(int) {
+            self temp = *this;
+            --*this;
+            return temp;
+        }
+    };
+
+    // Doubly linked list of objects that hold their links as the member `Hook`,
+    // or derive from `intrusive_list_hook` when `Hook` is left null.
+    // It never allocates, constructs or destroys the objects, the caller owns them and keeps them alive while they are linked.
+    // The links are relinked by the same operations as `list`, and an object is unlinked in O(1) by `erase`.
+    template <typename T, intrusive_list_hook T::*Hook = nullptr>
+    class intrusive_list {
+    public:
+        using value_type      = T;
+        using pointer         = T*;
+        using reference       = T&;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using const_pointer   = const T*;
+        using const_reference = const T&;
+        using hook_type       = intrusive_list_hook;
+
+        using iterator       = intrusive_list_iterator<T, Hook, T&, T*>;
+        using const_iterator = intrusive_list_iterator<T, Hook, const T&, const T*>;
+
+    protected:
+        using hook_traits = __hook_traits<T, hook_type, Hook>;
+
+        hook_type m_sentinel;
+        size_type m_size;
+
+        hook_type* sentinel() const { return const_cast<hook_type*>(&m_sentinel); }
+
+        void init() {
+            m_sentinel.next = &m_sentinel;
+            m_sentinel.prev = &m_sentinel;
+            m_size          = 0;
+        }
+
+        /// @brief: Link `hook` before `pos`.
+        static void link_before(hook_type* pos, hook_type* hook) {
+            hook->next      = pos;
+            hook->prev      = pos->prev;
+            pos->prev->next = hook;
+            pos->prev       = hook;
+        }
+
+        /// @brief: Unlink `hook` and mark it as not linked.
+        static hook_type* unlink(hook_type* hook) {
+            hook_type* next  = hook->next;
+            hook->prev->next = next;
+            next->prev       = hook->prev;
+            hook->prev       = nullptr;
+            hook->next       = nullptr;
+            return next;
+        }
+
+    public:
+        intrusive_list() { init(); }
+
+        intrusive_list(const intrusive_list&)            = delete;
+        intrusive_list& operator=(const intrusive_list&) = delete;
+
+        intrusive_list(intrusive_list&& other) {
+            init();
+            splice(end(), other);
+        }
+
+        intrusive_list& operator=(intrusive_list&& other) {
+            if (this != &other) {
+                clear();
+                splice(end(), other);
+            }
+            return *this;
+        }
+
+        // The objects are only unlinked.
+        ~intrusive_list() { clear(); }
+
+        iterator begin() { return m_sentinel.next; }
+        iterator end() { return sentinel(); }
+        const_iterator begin() const { return m_sentinel.next; }
+        const_iterator end() const { return sentinel(); }
+        const_iterator cbegin() const { return m_sentinel.next; }
+        const_iterator cend() const { return sentinel(); }
+
+        size_type size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        reference front() { return *begin(); }
+        reference back() { return *(--end()); }
+        const_reference front() const { return *begin(); }
+        const_reference back() const { return *(--end()); }
+
+        /// @brief Iterator to `value`, which should be on this list, in O(1).
+        static iterator iterator_to(reference value) { return iterator(hook_traits::to_hook(value)); }
+        static const_iterator iterator_to(const_reference value) { return const_iterator(const_cast<hook_type*>(hook_traits::to_hook(value))); }
+
+        iterator insert(iterator pos, reference value) {
+            hook_type* hook = hook_traits::to_hook(value);
+            link_before(pos.m_inner, hook);
+            ++m_size;
+            return iterator(hook);
+        }
+
+        void push_front(reference value) { insert(begin(), value); }
+        void push_back(reference value) { insert(end(), value); }
+
+        iterator erase(iterator pos) {
+            --m_size;
+            return iterator(unlink(pos.m_inner));
+        }
+
+        iterator erase(iterator first, iterator last) {
+            while (first != last) {
+                first = erase(first);
+            }
+            return last;
+        }
+
+        /// @brief Unlink `value`, which should be on this list, in O(1).
+        iterator erase(reference value) { return erase(iterator_to(value)); }
+
+        void pop_front() { erase(begin()); }
+        void pop_back() { erase(--end()); }
+
+        void clear() {
+            hook_type* curr = m_sentinel.next;
+            while (curr != &m_sentinel) {
+                hook_type* next = curr->next;
+                curr->prev      = nullptr;
+                curr->next      = nullptr;
+                curr            = next;
+            }
+            init();
+        }
+
+        template <typename Predicate>
+        void remove_if(Predicate pred) {
+            iterator first = begin();
+            while (first != end()) {
+                if (pred(*first)) {
+                    first = erase(first);
+                }
+                else {
+                    ++first;
+                }
+            }
+        }
+
+        void splice(iterator pos, intrusive_list& other) {
+            if (!other.empty()) {
+                list_transfer(pos.m_inner, other.m_sentinel.next, other.sentinel());
+                m_size      += other.m_size;
+                other.m_size = 0;
+            }
+        }
+
+        void splice(iterator pos, intrusive_list& other, iterator i) {
+            iterator j = i;
+            ++j;
+            if (pos == i || pos == j) {
+                return;
+            }
+            list_transfer(pos.m_inner, i.m_inner, j.m_inner);
+            ++m_size;
+            --other.m_size;
+        }
+
+        // Linear in the length of [`first`, `last`) when it comes from another list, to count it.
+        void splice(iterator pos, intrusive_list& other, iterator first, iterator last) {
+            if (first != last) {
+                size_type n = this == &other ? 0 : (size_type)TinySTL::distance(first, last);
+                splice(pos, other, first, last, n);
+            }
+        }
+
+        // Constant time, `n` should be the length of [`first`, `last`).
+        void splice(iterator pos, intrusive_list& other, iterator first, iterator last, size_type n) {
+            if (first != last) {
+                list_transfer(pos.m_inner, first.m_inner, last.m_inner);
+                m_size       += n;
+                other.m_size -= n;
+            }
+        }
+
+        // Merge two sorted list in ascending order, if the same, this list first.
+        void merge(intrusive_list& other) { merge(other, TinySTL::less<T>()); }
+
+        template <typename Compare>
+        void merge(intrusive_list& other, Compare comp) {
+            if (this == &other) {
+                return;
+            }
+            typename hook_traits::template compare<Compare> hook_comp(comp);
+            list_merge(sentinel(), other.sentinel(), hook_comp);
+            m_size      += other.m_size;
+            other.m_size = 0;
+        }
+
+        // Stable merge sort on the links, like `list::sort`.
+        void sort() { sort(TinySTL::less<T>()); }
+
+        template <typename Compare>
+        void sort(Compare comp) {
+            typename hook_traits::template compare<Compare> hook_comp(comp);
+            list_sort(sentinel(), hook_comp);
+        }
+
+        void reverse() {
+            // Do nothing if size() is 0 or 1.
+            if (m_size >= 2) {
+                hook_type* first = m_sentinel.next->next;
+                while (first != &m_sentinel) {
+                    hook_type* old = first;
+                    first          = first->next;
+                    // Move to begin() one by one.
+                    list_transfer(m_sentinel.next, old, first);
+                }
+            }
+        }
+
+        // The sentinels stay in place, so the content is moved by splicing.
+        friend void swap(intrusive_list& lhs, intrusive_list& rhs) {
+            if (&lhs != &rhs) {
+                intrusive_list temp;
+                temp.splice(temp.end(), lhs);
+                lhs.splice(lhs.end(), rhs);
+                rhs.splice(rhs.end(), temp);
+            }
+        }
+    };
+
+    template <typename T, intrusive_forward_list_hook T::*Hook, typename Ref, typename Ptr>
+    struct intrusive_forward_list_iterator : public forward_list_iterator_base {
+        using iterator       = intrusive_forward_list_iterator<T, Hook, T&, T*>;
+        using const_iterator = intrusive_forward_list_iterator<T, Hook, const T&, const T*>;
+        using self           = intrusive_forward_list_iterator<T, Hook, Ref, Ptr>;
+
+        using value_type = T;
+        using pointer    = Ptr;
+        using reference  = Ref;
+
+        using hook_traits = __hook_traits<T, intrusive_forward_list_hook, Hook>;
+
+        intrusive_forward_list_iterator(forward_list_node_base* inner = nullptr)
+            : forward_list_iterator_base(inner) {}
+
+        intrusive_forward_list_iterator(const iterator& other)
+            : forward_list_iterator_base(other.m_inner) {}
+
+        reference operator*() const { return *hook_traits::to_value(static_cast<intrusive_forward_list_hook*>(m_inner)); }
+
+        pointer operator->() const { return &(operator*()); }
+
+        self& operator++() {
+            increment();
+            return *this;
+        }
+
+        self operator++(int) {
+            self temp = *this;
+            increment();
+            return temp;
+        }
+    };
+
+    // Singly linked list of objects that hold their links as the member `Hook`, on the link operations of `forward_list`.
+    // Objects deriving from `intrusive_forward_list_hook` leave `Hook` null.
+    // It never allocates, constructs or destroys the objects.
+    // An object is unlinked in O(1) by `erase_after` its previous one, `erase` has to look for the previous one.
+    template <typename T, intrusive_forward_list_hook T::*Hook = nullptr>
+    class intrusive_forward_list {
+    public:
+        using value_type      = T;
+        using pointer         = T*;
+        using reference       = T&;
+        using const_pointer   = const T*;
+        using const_reference = const T&;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using hook_type       = intrusive_forward_list_hook;
+
+        using iterator       = intrusive_forward_list_iterator<T, Hook, T&, T*>;
+        using const_iterator = intrusive_forward_list_iterator<T, Hook, const T&, const T*>;
+
+    private:
+        using hook_traits    = __hook_traits<T, hook_type, Hook>;
+        using list_node_base = forward_list_node_base;
+
+        list_node_base m_head;
+        size_type m_size;
+
+        /// @brief: Unlink the object after `pos`.
+        static list_node_base* unlink_after(list_node_base* pos) {
+            list_node_base* next = pos->next;
+            pos->next            = next->next;
+            next->next           = nullptr;
+            return pos->next;
+        }
+
+    public:
+        intrusive_forward_list()
+            : m_size(0) {
+            m_head.next = nullptr;
+        }
+
+        intrusive_forward_list(const intrusive_forward_list&)            = delete;
+        intrusive_forward_list& operator=(const intrusive_forward_list&) = delete;
+
+        // The head holds no link back to itself, so the objects are taken over as they are.
+        intrusive_forward_list(intrusive_forward_list&& other)
+            : m_size(other.m_size) {
+            m_head.next       = other.m_head.next;
+            other.m_head.next = nullptr;
+            other.m_size      = 0;
+        }
+
+        intrusive_forward_list& operator=(intrusive_forward_list&& other) {
+            if (this != &other) {
+                clear();
+                swap(*this, other);
+            }
+            return *this;
+        }
+
+        // The objects are only unlinked.
+        ~intrusive_forward_list() { clear(); }
+
+        iterator before_begin() { return iterator(&m_head); }
+        iterator begin() { return iterator(m_head.next); }
+        iterator end() { return iterator(nullptr); }
+        const_iterator before_begin() const { return const_iterator(const_cast<list_node_base*>(&m_head)); }
+        const_iterator begin() const { return const_iterator(m_head.next); }
+        const_iterator end() const { return const_iterator(nullptr); }
+        const_iterator cbegin() const { return const_iterator(m_head.next); }
+        const_iterator cend() const { return const_iterator(nullptr); }
+
+        size_type size() const { return m_size; }
+        bool empty() const { return m_head.next == nullptr; }
+
+        reference front() { return *begin(); }
+        const_reference front() const { return *begin(); }
+
+        /// @brief Iterator to `value`, which should be on this list, in O(1).
+        static iterator iterator_to(reference value) { return iterator(hook_traits::to_hook(value)); }
+        static const_iterator iterator_to(const_reference value) { return const_iterator(const_cast<hook_type*>(hook_traits::to_hook(value))); }
+
+        iterator previous(const_iterator pos) {
+            return iterator(forward_list_previous(&m_head, pos.m_inner));
+        }
+
+        iterator insert_after(iterator pos, reference value) {
+            ++m_size;
+            return iterator(forward_list_make_link(pos.m_inner, hook_traits::to_hook(value)));
+        }
+
+        void push_front(reference value) { insert_after(before_begin(), value); }
+
+        iterator erase_after(iterator pos) {
+            --m_size;
+            return iterator(unlink_after(pos.m_inner));
+        }
+
+        iterator erase_after(iterator before_first, iterator last) {
+            while (before_first.m_inner->next != last.m_inner) {
+                erase_after(before_first);
+            }
+            return last;
+        }
+
+        /// @brief Unlink `value`, which should be on this list, linear in its position.
+        iterator erase(reference value) { return erase_after(previous(iterator_to(value))); }
+
+        void pop_front() { erase_after(before_begin()); }
+
+        void clear() {
+            list_node_base* curr = m_head.next;
+            while (curr != nullptr) {
+                list_node_base* next = curr->next;
+                curr->next           = nullptr;
+                curr                 = next;
+            }
+            m_head.next = nullptr;
+            m_size      = 0;
+        }
+
+        template <typename Predicate>
+        void remove_if(Predicate pred) {
+            list_node_base* curr = &m_head;
+            while (curr->next != nullptr) {
+                if (pred(*hook_traits::to_value(static_cast<hook_type*>(curr->next)))) {
+                    unlink_after(curr);
+                    --m_size;
+                }
+                else {
+                    curr = curr->next;
+                }
+            }
+        }
+
+        // Move the object after `prev` of `other` after `pos`.
+        void splice_after(iterator pos, intrusive_forward_list& other, iterator prev) {
+            forward_list_splice_after(pos.m_inner, prev.m_inner, prev.m_inner->next);
+            ++m_size;
+            --other.m_size;
+        }
+
+        // Move (`before_first`, `before_last`] of `other` after `pos`.
+        // Linear in the length of the range when it comes from another list, to count it.
+        void splice_after(iterator pos, intrusive_forward_list& other, iterator before_first, iterator before_last) {
+            if (before_first != before_last) {
+                size_type n = 0;
+                if (this != &other) {
+                    for (list_node_base* curr = before_first.m_inner; curr != before_last.m_inner; curr = curr->next) {
+                        ++n;
+                    }
+                }
+                splice_after(pos, other, before_first, before_last, n);
+            }
+        }
+
+        // Constant time, `n` should be the length of (`before_first`, `before_last`].
+        void splice_after(iterator pos, intrusive_forward_list& other, iterator before_first, iterator before_last, size_type n) {
+            if (before_first != before_last) {
+                forward_list_splice_after(pos.m_inner, before_first.m_inner, before_last.m_inner);
+                m_size       += n;
+                other.m_size -= n;
+            }
+        }
+
+        // Move all the objects of `other` after `pos`.
+        void splice_after(iterator pos, intrusive_forward_list& other) {
+            if (other.m_head.next) {
+                forward_list_splice_after(pos.m_inner, &other.m_head, forward_list_previous(&other.m_head, nullptr));
+                m_size      += other.m_size;
+                other.m_size = 0;
+            }
+        }
+
+        // Merge two sorted list in ascending order, if the same, this list first.
+        void merge(intrusive_forward_list& other) { merge(other, TinySTL::less<T>()); }
+
+        template <typename Compare>
+        void merge(intrusive_forward_list& other, Compare comp) {
+            if (this == &other) {
+                return;
+            }
+            link_compare<Compare> link_comp(comp);
+            forward_list_merge(&m_head, &other.m_head, link_comp);
+            m_size      += other.m_size;
+            other.m_size = 0;
+        }
+
+        // Stable merge sort on the links, like `forward_list::sort`.
+        void sort() { sort(TinySTL::less<T>()); }
+
+        template <typename Compare>
+        void sort(Compare comp) {
+            if (m_size >= 2) {
+                link_compare<Compare> link_comp(comp);
+                m_head.next = forward_list_sort_chain(m_head.next, link_comp);
+            }
+        }
+
+        void reverse() {
+            if (m_head.next) {
+                m_head.next = forward_list_reverse(m_head.next);
+            }
+        }
+
+        friend void swap(intrusive_forward_list& lhs, intrusive_forward_list& rhs) {
+            TinySTL::swap(lhs.m_head.next, rhs.m_head.next);
+            TinySTL::swap(lhs.m_size, rhs.m_size);
+        }
+
+    private:
+        // Compare two links by their objects, the links of the head and of the hooks are both `forward_list_node_base`.
+        template <typename Compare>
+        struct link_compare {
+            Compare comp;
+
+            explicit link_compare(Compare c)
+                : comp(c) {}
+
+            bool operator()(const list_node_base* lhs, const list_node_base* rhs) {
+                return comp(*hook_traits::to_value(static_cast<const hook_type*>(lhs)), *hook_traits::to_value(static_cast<const hook_type*>(rhs)));
+            }
+        };
+    };
+
+} // namespace TinySTL
+
+#endif // !_TINYSTL_INTRUSIVE_LIST_HPP_
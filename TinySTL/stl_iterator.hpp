@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <iostream>
+#include <stl_type_traits.hpp>
 
 namespace TinySTL {
 
@@ -85,6 +86,20 @@ namespace TinySTL {
         using reference         = const T&;
     };
 
+    // Segmented iterators walk over a sequence of contiguous segments, such as the buffers of a deque.
+    // The algorithms specialized for them run over each segment with its local iterators,
+    // which are usually plain pointers, instead of checking the segment boundary at every step.
+    // A segmented iterator specializes this traits with:
+    // `is_segmented`: `__true_type`.
+    // `segment_iterator`, `local_iterator`: iterators over the segments and over one segment.
+    // `segment(it)`, `local(it)`: the segment of `it` and the position of `it` in it.
+    // `begin(seg)`, `end(seg)`: the range of a segment.
+    // `compose(seg, local)`: the iterator at `local` in `seg`.
+    template <typename I>
+    struct __segmented_iterator_traits {
+        using is_segmented = __false_type;
+    };
+
     // Determine iterator category.
     template <typename I>
     constexpr typename iterator_traits<I>::iterator_category __iterator_category(const I&) {
@@ -107,19 +122,19 @@ namespace TinySTL {
     // Determine iterator category.
     template <typename I>
     constexpr typename iterator_traits<I>::iterator_category iterator_category(const I& it) {
-        return __iterator_category(it);
+        return TinySTL::__iterator_category(it);
     }
 
     // Determine iterator distance type.
     template <typename I>
     constexpr typename iterator_traits<I>::difference_type* distance_type(const I& it) {
-        return __distance_type(it);
+        return TinySTL::__distance_type(it);
     }
 
     // Determine iterator value type.
     template <typename I>
     constexpr typename iterator_traits<I>::value_type* value_type(const I& it) {
-        return __value_type(it);
+        return TinySTL::__value_type(it);
     }
 
     // For input iterator.
@@ -146,7 +161,7 @@ namespace TinySTL {
     inline typename iterator_traits<I>::difference_type
     distance(I first, I last) {
         using category = typename iterator_traits<I>::iterator_category;
-        return __distance(first, last, category());
+        return TinySTL::__distance(first, last, category());
     }
 
     // For input iterator.
@@ -3,6 +3,7 @@
 
 #include <stl_algorithm.hpp>
 #include <stl_allocator.hpp>
+#include <stl_function.hpp>
 #include <stl_iterator.hpp>
 #include <stl_type_traits.hpp>
 #include <stl_uninitialized.hpp>
@@ -16,6 +17,122 @@ namespace TinySTL {
         T data;
     };
 
+    // The link operations below work on any node type with `prev` and `next` links,
+    // they are shared by `list` and `intrusive_list`.
+
+    // Move [first, last) to the position end with `pos`, the nodes may come from another list.
+    template <typename Node>
+    inline void list_transfer(Node* pos, Node* first, Node* last) {
+        if (pos != last) {
+            // Next connection of `pos`.
+            last->prev->next  = pos;
+            first->prev->next = last;
+            pos->prev->next   = first;
+
+            // Prev connection of `pos`.
+            Node* temp  = pos->prev;
+            pos->prev   = last->prev;
+            last->prev  = first->prev;
+            first->prev = temp;
+        }
+    }
+
+    // Merge the sorted list of `other` into the sorted list of `sentinel`, `comp` compares two nodes.
+    // Equal nodes of `sentinel` go first.
+    template <typename Node, typename Compare>
+    void list_merge(Node* sentinel, Node* other, Compare& comp) {
+        Node* first1 = sentinel->next;
+        Node* first2 = other->next;
+        while (first1 != sentinel && first2 != other) {
+            if (comp(first2, first1)) {
+                Node* next = first2->next;
+                list_transfer(first1, first2, next);
+                first2 = next;
+            }
+            else {
+                first1 = first1->next;
+            }
+        }
+        if (first2 != other) {
+            list_transfer(sentinel, first2, other);
+        }
+    }
+
+    // Merge two sorted chains ended with `nullptr`, the nodes of `a` go first among the equal ones.
+    template <typename Node, typename Compare>
+    Node* list_merge_chain(Node* a, Node* b, Compare& comp) {
+        Node* result = nullptr;
+        Node** tail  = &result;
+        while (a != nullptr && b != nullptr) {
+            if (comp(b, a)) {
+                *tail = b;
+                tail  = &b->next;
+                b     = b->next;
+            }
+            else {
+                *tail = a;
+                tail  = &a->next;
+                a     = a->next;
+            }
+        }
+        *tail = a != nullptr ? a : b;
+        return result;
+    }
+
+    // Bottom-up merge sort of a chain ended with `nullptr`, it only uses the `next` links.
+    // `bins[i]` holds a sorted chain of 2 ^ i nodes, the nodes are put into the bins one by one and carried up like a binary counter.
+    template <typename Node, typename Compare>
+    Node* list_sort_chain(Node* first, Compare& comp) {
+        // Upper limit 2 ^ 64.
+        Node* bins[64] = {};
+        int fill       = 0;
+        while (first != nullptr) {
+            Node* carry = first;
+            first       = first->next;
+            carry->next = nullptr;
+            int i       = 0;
+            for (; i < fill && bins[i] != nullptr; ++i) {
+                carry   = list_merge_chain(bins[i], carry, comp);
+                bins[i] = nullptr;
+            }
+            bins[i] = carry;
+            if (i == fill) {
+                ++fill;
+            }
+        }
+        // The higher bins hold the earlier nodes.
+        Node* result = nullptr;
+        for (int i = 0; i < fill; ++i) {
+            if (bins[i] != nullptr) {
+                result = result == nullptr ? bins[i] : list_merge_chain(bins[i], result, comp);
+            }
+        }
+        return result;
+    }
+
+    // Make the chain ended with `nullptr` the content of the list of `sentinel`, setting the `prev` links.
+    template <typename Node>
+    void list_link_chain(Node* sentinel, Node* first) {
+        Node* prev     = sentinel;
+        sentinel->next = first;
+        for (; first != nullptr; first = first->next) {
+            first->prev = prev;
+            prev        = first;
+        }
+        prev->next     = sentinel;
+        sentinel->prev = prev;
+    }
+
+    // Stable merge sort of the list of `sentinel` on the links of the nodes.
+    template <typename Node, typename Compare>
+    void list_sort(Node* sentinel, Compare& comp) {
+        // Do nothing if size() is 0 or 1.
+        if (sentinel->next != sentinel && sentinel->next->next != sentinel) {
+            sentinel->prev->next = nullptr;
+            list_link_chain(sentinel, list_sort_chain(sentinel->next, comp));
+        }
+    }
+
     template <typename T, typename Ref, typename Ptr>
     struct list_iterator {
         using iterator       = list_iterator<T, T&, T*>;
@@ -85,7 +202,7 @@ namespace TinySTL {
     }
 
     template <typename T, typename Alloc = alloc>
-    class list {
+    class list : private simple_alloc<list_node<T>, Alloc> {
     public:
         using value_type      = T;
         using pointer         = T*;
@@ -97,12 +214,15 @@ namespace TinySTL {
         using node            = list_node<T>;
 
         using list_allocator = simple_alloc<node, Alloc>;
+        using allocator_type = Alloc;
 
         using iterator       = list_iterator<T, T&, T*>;
         using const_iterator = list_iterator<T, const T&, const T*>;
 
     protected:
         node* m_sentinel;
+        // Number of elements, kept by every operation that links or unlinks nodes.
+        size_type m_size;
 
     private:
         node* get_node() { return list_allocator::allocate((size_type)1); }
@@ -123,32 +243,42 @@ namespace TinySTL {
             m_sentinel       = get_node();
             m_sentinel->next = m_sentinel;
             m_sentinel->prev = m_sentinel;
+            m_size           = 0;
         }
 
     public:
         list() { init(); }
 
+        explicit list(const Alloc& a)
+            : list_allocator(a) {
+            init();
+        }
+
         explicit list(size_type n) {
             init();
             insert(begin(), n, value_type());
         }
 
-        list(size_type n, const T& value) {
+        list(size_type n, const T& value, const Alloc& a = Alloc())
+            : list_allocator(a) {
             init();
             insert(begin(), n, value);
         }
 
-        list(const T* first, const T* last) {
+        list(const T* first, const T* last, const Alloc& a = Alloc())
+            : list_allocator(a) {
             init();
             insert(begin(), first, last);
         }
 
-        list(const_iterator first, const_iterator last) {
+        list(const_iterator first, const_iterator last, const Alloc& a = Alloc())
+            : list_allocator(a) {
             init();
             insert(begin(), first, last);
         }
 
-        list(const list& other) {
+        list(const list& other)
+            : list_allocator(other.get_allocator()) {
             init();
             insert(begin(), other.begin(), other.end());
         }
@@ -180,6 +310,8 @@ namespace TinySTL {
             put_node(m_sentinel);
         }
 
+        allocator_type get_allocator() const { return list_allocator::get_allocator(); }
+
         iterator begin() { return m_sentinel->next; }
         iterator end() { return m_sentinel; }
         const_iterator begin() const { return m_sentinel->next; }
@@ -187,7 +319,7 @@ namespace TinySTL {
         const_iterator cbegin() const { return m_sentinel->next; }
         const_iterator cend() const { return m_sentinel; }
 
-        size_type size() const { return distance(begin(), end()); }
+        size_type size() const { return m_size; }
         bool empty() { return m_sentinel->next == m_sentinel; }
 
         reference front() { return *begin(); }
@@ -196,15 +328,18 @@ namespace TinySTL {
         const_reference back() const { return *(--end()); }
 
         friend bool operator==(const list& lhs, const list& rhs) {
+            // Same size.
+            if (lhs.size() != rhs.size()) {
+                return false;
+            }
             auto b1 = lhs.begin(), e1 = lhs.end();
-            auto b2 = rhs.begin(), e2 = rhs.end();
+            auto b2 = rhs.begin();
             // Same data.
-            for (; b1 != e1 && b2 != e2; ++b1, ++b2) {
+            for (; b1 != e1; ++b1, ++b2) {
                 if (*b1 != *b2)
                     return false;
             }
-            // Same size.
-            return b1 == e1 && b2 == e2;
+            return true;
         }
 
         friend bool operator!=(const list& lhs, const list& rhs) {
@@ -233,6 +368,7 @@ namespace TinySTL {
             temp->prev              = pos.m_inner->prev;
             pos.m_inner->prev->next = temp;
             pos.m_inner->prev       = temp;
+            ++m_size;
             return iterator(temp);
         }
 
@@ -264,6 +400,7 @@ namespace TinySTL {
             next_node->prev = prev_node;
             destory(&(pos.m_inner->data));
             put_node(pos.m_inner);
+            --m_size;
             return iterator(next_node);
         }
 
@@ -296,20 +433,26 @@ namespace TinySTL {
         }
 
         void clear() {
+            // Give all the nodes back to the allocator at once.
+            __node_chain<node> chain;
             node* curr = m_sentinel->next;
             while (curr != m_sentinel) {
                 node* temp = curr;
                 curr       = curr->next;
                 destory(&(temp->data));
-                put_node(temp);
+                chain.push(temp);
             }
+            list_allocator::deallocate_chain(chain);
             m_sentinel->next = m_sentinel;
             m_sentinel->prev = m_sentinel;
+            m_size           = 0;
         }
 
         friend void swap(list& lhs, list& rhs) noexcept {
             using TinySTL::swap;
+            swap(static_cast<list_allocator&>(lhs), static_cast<list_allocator&>(rhs));
             swap(lhs.m_sentinel, rhs.m_sentinel);
+            swap(lhs.m_size, rhs.m_size);
         }
 
         void remove(const T& value) {
@@ -345,89 +488,60 @@ namespace TinySTL {
 
     protected:
         // Move [first, last) to the position end with `pos`.
+        // It only relinks the nodes, the callers move the count of them between the lists.
         void transfer(iterator pos, iterator first, iterator last) {
-            if (pos != last) {
-                // Next connection of `pos`.
-                last.m_inner->prev->next  = pos.m_inner;
-                first.m_inner->prev->next = last.m_inner;
-                pos.m_inner->prev->next   = first.m_inner;
-
-                // Prev connection of `pos`.
-                node* temp          = pos.m_inner->prev;
-                pos.m_inner->prev   = last.m_inner->prev;
-                last.m_inner->prev  = first.m_inner->prev;
-                first.m_inner->prev = temp;
-            }
+            list_transfer(pos.m_inner, first.m_inner, last.m_inner);
         }
 
     public:
         void splice(iterator pos, list& other) {
             if (!other.empty()) {
                 transfer(pos, other.begin(), other.end());
+                m_size      += other.m_size;
+                other.m_size = 0;
             }
         }
 
-        void splice(iterator pos, list&, iterator i) {
+        void splice(iterator pos, list& other, iterator i) {
             iterator j = i;
             ++j;
             if (pos == i || pos == j) {
                 return;
             }
             transfer(pos, i, j);
+            ++m_size;
+            --other.m_size;
         }
 
-        void splice(iterator pos, list&, iterator first, iterator last) {
+        // Linear in the length of [`first`, `last`) when it comes from another list, to count it.
+        void splice(iterator pos, list& other, iterator first, iterator last) {
             if (first != last) {
-                transfer(pos, first, last);
+                size_type n = this == &other ? 0 : (size_type)TinySTL::distance(first, last);
+                splice(pos, other, first, last, n);
             }
         }
 
-        // Merge two sorted list in ascending order.
-        void merge(list& other) {
-            iterator first1 = begin();
-            iterator last1  = end();
-            iterator first2 = other.begin();
-            iterator last2  = other.end();
-
-            while (first1 != last1 && first2 != last2) {
-                // It may only overload <.
-                if (*first2 < *first1) {
-                    iterator next = first2;
-                    transfer(first1, first2, ++next);
-                    // No ++first2 here, because first2 is after first1 now,
-                    // which means first2 is on this list.
-                    first2 = next;
-                }
-                else {
-                    // If the same, list1 first.
-                    ++first1;
-                }
-            }
-            if (first2 != last2) {
-                transfer(last1, first2, last2);
+        // Constant time, `n` should be the length of [`first`, `last`).
+        void splice(iterator pos, list& other, iterator first, iterator last, size_type n) {
+            if (first != last) {
+                transfer(pos, first, last);
+                m_size       += n;
+                other.m_size -= n;
             }
         }
 
+        // Merge two sorted list in ascending order, if the same, list1 first.
+        void merge(list& other) { merge(other, TinySTL::less<T>()); }
+
         template <typename Compare>
         void merge(list& other, Compare comp) {
-            iterator first1 = begin();
-            iterator last1  = end();
-            iterator first2 = other.begin();
-            iterator last2  = other.end();
-
-            while (first1 != last1 && first2 != last2) {
-                if (comp(*first2, *first1)) {
-                    iterator next = first2;
-                    transfer(first1, first2, ++next);
-                    first2 = next;
-                }
-                else {
-                    ++first1;
-                }
-            }
-            if (first2 != last2) {
-                transfer(last1, first2, last2);
+            if (this == &other) {
+                return;
             }
+            __node_data_compare<node, Compare> node_comp(comp);
+            list_merge(m_sentinel, other.m_sentinel, node_comp);
+            m_size      += other.m_size;
+            other.m_size = 0;
         }
 
         void reverse() {
@@ -444,65 +558,56 @@ namespace TinySTL {
             }
         }
 
-        // Merge sort.
-        void sort() {
-            // Do nothing if size() is 0 or 1.
-            if (m_sentinel->next != m_sentinel && m_sentinel->next->next != m_sentinel) {
-                list carry;
-                // Upper limit 2 ^ 64.
-                list counter[64];
-
-                int fill = 0;
-                while (!empty()) {
-                    // Put the begin() to carry's begin() one by one.
-                    carry.splice(carry.begin(), *this, begin());
-                    int i = 0;
-                    while (i < fill && !counter[i].empty()) {
-                        // Here we sort it.
-                        counter[i].merge(carry);
-                        carry.swap(counter[i++]);
-                    }
-                    carry.swap(counter[i]);
-                    if (i == fill) {
-                        ++fill;
-                    }
-                }
-                for (int i = 1; i < fill; ++i) {
-                    counter[i].merge(counter[i - 1]);
-                }
-                swap(counter[fill - 1]);
-            }
-        }
+        // Stable merge sort on the links of the nodes, it allocates nothing.
+        void sort() { sort(TinySTL::less<T>()); }
 
         template <typename Compare>
         void sort(Compare comp) {
-            // Do nothing if size() is 0 or 1.
-            if (m_sentinel->next != m_sentinel && m_sentinel->next->next != m_sentinel) {
-                list carry;
-                // Upper limit 2 ^ 64.
-                list counter[64];
-
-                int fill = 0;
-                while (!empty()) {
-                    // Put the begin() to carry's begin() one by one.
-                    carry.splice(carry.begin(), *this, begin());
-                    int i = 0;
-                    while (i < fill && !counter[i].empty()) {
-                        // Here we sort it.
-                        counter[i].merge(carry, comp);
-                        carry.swap(counter[i++]);
-                    }
-                    carry.swap(counter[i]);
-                    if (i == fill) {
-                        ++fill;
-                    }
-                }
-                for (int i = 1; i < fill; ++i) {
-                    counter[i].merge(counter[i - 1]);
-                }
-                swap(counter[fill - 1]);
+            __node_data_compare<node, Compare> node_comp(comp);
+            list_sort(m_sentinel, node_comp);
+        }
+
+        // Sort by introsort over an array of the node pointers, which is faster on long lists whose nodes are scattered in memory.
+        // The order of equal elements is not kept. Short lists fall back to `sort`.
+        void unstable_sort() { unstable_sort(TinySTL::less<T>()); }
+
+        template <typename Compare>
+        void unstable_sort(Compare comp) {
+            if (m_size < _ARRAY_SORT_THRESHOLD) {
+                sort(comp);
+                return;
+            }
+            // Allocate through the stored allocator, a stateful one has no static functions.
+            node_pointer_allocator pointer_allocator(get_allocator());
+            node** nodes = pointer_allocator.allocate(m_size);
+            node** last  = nodes;
+            for (node* curr = m_sentinel->next; curr != m_sentinel; curr = curr->next) {
+                *last++ = curr;
             }
+            try {
+                TinySTL::sort(nodes, last, __node_data_compare<node, Compare>(comp));
+            }
+            catch (const std::exception&) {
+                // The links are not touched yet.
+                pointer_allocator.deallocate(nodes, m_size);
+                throw;
+            }
+            // Relink the nodes in the order of the array.
+            node* prev = m_sentinel;
+            for (node** curr = nodes; curr != last; ++curr) {
+                prev->next    = *curr;
+                (*curr)->prev = prev;
+                prev          = *curr;
+            }
+            prev->next       = m_sentinel;
+            m_sentinel->prev = prev;
+            pointer_allocator.deallocate(nodes, m_size);
         }
+
+    protected:
+        enum { _ARRAY_SORT_THRESHOLD = 1 << 12 };
+
+        using node_pointer_allocator = simple_alloc<node*, Alloc>;
     };
 
 } // namespace TinySTL
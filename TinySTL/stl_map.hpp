@@ -6,8 +6,13 @@
 
 namespace TinySTL {
 
+    template <typename Key, typename Value, typename Compare, typename Alloc>
+    class multimap;
+
     template <typename Key, typename Value, typename Compare = TinySTL::less<Key>, typename Alloc = alloc>
     class map {
+        friend class multimap<Key, Value, Compare, Alloc>;
+
     public:
         using key_type    = Key;
         using data_type   = Value;
@@ -30,7 +35,7 @@ namespace TinySTL {
         };
 
     private:
-        using rep_type = rb_tree<key_type, value_type, select1st<value_type>, key_compare, Alloc>;
+        using rep_type = rbtree<key_type, value_type, select1st<value_type>, key_compare, Alloc>;
         rep_type t;
 
     public:
@@ -43,6 +48,7 @@ namespace TinySTL {
         using size_type       = typename rep_type::size_type;
         using difference_type = typename rep_type::difference_type;
         using allocator_type  = typename rep_type::allocator_type;
+        using node_type       = typename rep_type::node_type;
 
         map()
             : t(Compare(), allocator_type()) {}
@@ -73,12 +79,13 @@ namespace TinySTL {
         map(const map& x)
             : t(x.t) {}
 
-        map operator=(const map& x) {
+        map& operator=(const map& x) {
             t = x.t;
             return *this;
         }
 
     public:
+        allocator_type get_allocator() const { return t.get_allocator(); }
         key_compare key_comp() const { return t.key_comp(); }
         value_compare value_comp() const { return value_compare(t.key_comp()); }
 
@@ -128,6 +135,17 @@ namespace TinySTL {
 
         void clear() { t.clear(); }
 
+        /// @brief Take the node of `position` out of the map, its key can be changed before it is inserted again.
+        node_type extract(iterator position) { return t.extract(position); }
+        node_type extract(const key_type& x) { return t.extract(x); }
+
+        /// @brief Insert the node of `node` without allocating, it stays in `node` if the key is taken.
+        TinySTL::pair<iterator, bool> insert(node_type&& node) { return t.insert_unique(std::move(node)); }
+
+        /// @brief Move the entries of `source` whose keys are not in this map by relinking their nodes.
+        void merge(map& source) { t.merge_unique(source.t); }
+        void merge(multimap<Key, Value, Compare, Alloc>& source) { t.merge_unique(source.t); }
+
         iterator find(const key_type& x) { return t.find(x); }
         const_iterator find(const key_type& x) const { return t.find(x); }
         size_type count(const key_type& x) const { return t.count(x); }
@@ -0,0 +1,343 @@
+#ifndef _TINYSTL_MMAP_VECTOR_HPP_
+#define _TINYSTL_MMAP_VECTOR_HPP_
+
+#include <cerrno>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <stl_vector.hpp>
+
+#ifdef TINYSTL_HAS_MMAP
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+
+namespace TinySTL {
+
+    // Access patterns passed to `madvise`.
+    enum mmap_advice {
+        mmap_normal,
+        // Read ahead aggressively and drop the pages behind.
+        mmap_sequential,
+        // No read ahead.
+        mmap_random,
+        // Read the pages in ahead of use.
+        mmap_willneed,
+        // The pages are not needed for now, they are written back and dropped.
+        mmap_dontneed
+    };
+
+    // Vector whose elements live in a file mapped by `mmap`, for data sets larger than the memory.
+    // The file holds the raw elements, an existing file is opened with all of its elements.
+    // Opening a file whose size is not a multiple of `sizeof(T)` throws, cutting it on close would lose its tail.
+    // Growth extends the file by `ftruncate` and the mapping by `mremap`, by `GrowthPolicy` in whole pages.
+    // The file is cut to the elements on destruction.
+    // The iterators are plain pointers into the mapping, so the algorithms run over it in place.
+    // Only for trivially copyable `T`, the elements are never constructed or destroyed.
+    // Errors of the system calls are thrown as `std::system_error`.
+    template <typename T, typename GrowthPolicy = __geometric_growth_policy<>>
+    class mmap_vector {
+        static_assert(std::is_trivially_copyable<T>::value, "The elements of mmap_vector should be trivially copyable.");
+
+    public:
+        using value_type      = T;
+        using pointer         = T*;
+        using iterator        = T*;
+        using reference       = T&;
+        using size_type       = size_t;
+        using difference_type = std::ptrdiff_t;
+        using const_pointer   = const T*;
+        using const_iterator  = const T*;
+        using const_reference = const T&;
+
+    protected:
+        // file descriptor, -1 if closed
+        int m_fd;
+        // start of the mapping
+        iterator m_start;
+        // number of elements
+        size_type m_size;
+        // number of elements the mapping holds
+        size_type m_capacity;
+
+    protected:
+        static void fail(const char* what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        static size_t page_bytes() {
+            static const size_t bytes = (size_t)sysconf(_SC_PAGESIZE);
+            return bytes;
+        }
+
+        /// @brief: Number of bytes of `n` elements, rounded up to whole pages.
+        static size_t mapped_bytes(size_type n) {
+            return (n * sizeof(T) + page_bytes() - 1) & ~(page_bytes() - 1);
+        }
+
+        /// @brief: Resize the file and the mapping to hold `new_capacity` elements.
+        void remap(size_type new_capacity) {
+            const size_t old_bytes = mapped_bytes(m_capacity);
+            const size_t new_bytes = mapped_bytes(new_capacity);
+            if (ftruncate(m_fd, (off_t)new_bytes) != 0) {
+                fail("mmap_vector: ftruncate");
+            }
+            void* space = nullptr;
+            if (new_bytes == 0) {
+                if (m_start != nullptr) {
+                    munmap(m_start, old_bytes);
+                }
+            }
+            else if (m_start == nullptr) {
+                space = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+            }
+            else {
+    #ifdef MREMAP_MAYMOVE
+                space = mremap(m_start, old_bytes, new_bytes, MREMAP_MAYMOVE);
+    #else
+                munmap(m_start, old_bytes);
+                space = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    #endif
+            }
+            if (space == MAP_FAILED) {
+                fail("mmap_vector: mmap");
+            }
+            m_start    = (iterator)space;
+            m_capacity = new_bytes / sizeof(T);
+        }
+
+        /// @brief: Make room for `n` more elements.
+        void reserve_more(size_type n) {
+            if (m_capacity - m_size < n) {
+                remap(GrowthPolicy::next(m_capacity, m_size + n));
+            }
+        }
+
+        /// @brief: Unmap and cut the file to the elements.
+        void close() {
+            if (m_fd == -1) {
+                return;
+            }
+            if (m_start != nullptr) {
+                munmap(m_start, mapped_bytes(m_capacity));
+            }
+            if (ftruncate(m_fd, (off_t)(m_size * sizeof(T))) != 0) {
+                // Nothing to do in a destructor, the file keeps its spare pages.
+            }
+            ::close(m_fd);
+            m_fd       = -1;
+            m_start    = nullptr;
+            m_size     = 0;
+            m_capacity = 0;
+        }
+
+    public:
+        mmap_vector()
+            : m_fd(-1)
+            , m_start(nullptr)
+            , m_size(0)
+            , m_capacity(0) {}
+
+        /// @brief Open or create the file at `path`, discard its content if `truncate`.
+        /// Throw `std::system_error` with `EINVAL` if the size of the file is not a multiple of `sizeof(T)`.
+        explicit mmap_vector(const char* path, bool truncate = false)
+            : m_fd(::open(path, O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), 0644))
+            , m_start(nullptr)
+            , m_size(0)
+            , m_capacity(0) {
+            if (m_fd == -1) {
+                fail("mmap_vector: open");
+            }
+            struct stat st;
+            if (fstat(m_fd, &st) != 0) {
+                int error = errno;
+                ::close(m_fd);
+                errno = error;
+                fail("mmap_vector: fstat");
+            }
+            if ((size_type)st.st_size % sizeof(T) != 0) {
+                ::close(m_fd);
+                errno = EINVAL;
+                fail("mmap_vector: file size is not a multiple of the element size");
+            }
+            m_size = (size_type)st.st_size / sizeof(T);
+            if (m_size != 0) {
+                try {
+                    remap(m_size);
+                }
+                catch (const std::exception&) {
+                    ::close(m_fd);
+                    throw;
+                }
+            }
+        }
+
+        mmap_vector(const mmap_vector&)            = delete;
+        mmap_vector& operator=(const mmap_vector&) = delete;
+
+        mmap_vector(mmap_vector&& other) noexcept
+            : m_fd(other.m_fd)
+            , m_start(other.m_start)
+            , m_size(other.m_size)
+            , m_capacity(other.m_capacity) {
+            other.m_fd       = -1;
+            other.m_start    = nullptr;
+            other.m_size     = 0;
+            other.m_capacity = 0;
+        }
+
+        mmap_vector& operator=(mmap_vector&& other) noexcept {
+            if (this != &other) {
+                close();
+                swap(*this, other);
+            }
+            return *this;
+        }
+
+        ~mmap_vector() {
+            close();
+        }
+
+    public:
+        iterator begin() { return m_start; }
+        iterator end() { return m_start + m_size; }
+        const_iterator begin() const { return m_start; }
+        const_iterator end() const { return m_start + m_size; }
+        const_iterator cbegin() const { return m_start; }
+        const_iterator cend() const { return m_start + m_size; }
+        pointer data() { return m_start; }
+        const_pointer data() const { return m_start; }
+
+        size_type size() const { return m_size; }
+        size_type capacity() const { return m_capacity; }
+        bool empty() const { return m_size == 0; }
+        bool is_open() const { return m_fd != -1; }
+
+        reference front() { return *begin(); }
+        reference back() { return *(end() - 1); }
+        reference operator[](size_type idx) { return *(begin() + idx); }
+        const_reference front() const { return *begin(); }
+        const_reference back() const { return *(end() - 1); }
+        const_reference operator[](size_type idx) const { return *(begin() + idx); }
+
+    public:
+        void push_back(const T& value) {
+            // Copy `value` first, since it may be an element of this vector.
+            T temp(value);
+            reserve_more(1);
+            m_start[m_size++] = temp;
+        }
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            push_back(T(std::forward<Args>(args)...));
+            return back();
+        }
+
+        void pop_back() {
+            --m_size;
+        }
+
+        /// @brief Append [`first`, `last`), the file grows at most once for a forward range.
+        template <typename InputIterator>
+        void append(InputIterator first, InputIterator last) {
+            append_aux(first, last, iterator_category(first));
+        }
+
+        /// @brief Append `n` elements and return the first of them, for the caller to fill in.
+        /// The new elements keep the bytes of the file, zeros where the file is newly extended.
+        iterator append_uninitialized(size_type n) {
+            reserve_more(n);
+            iterator first = end();
+            m_size += n;
+            return first;
+        }
+
+        iterator erase(iterator first, iterator last) {
+            TinySTL::copy(last, end(), first);
+            m_size -= last - first;
+            return first;
+        }
+
+        void clear() {
+            m_size = 0;
+        }
+
+        void resize(size_type new_size, const T& value = value_type()) {
+            if (new_size <= m_size) {
+                m_size = new_size;
+            }
+            else {
+                T temp(value);
+                const size_type n = new_size - m_size;
+                TinySTL::fill_n(append_uninitialized(n), n, temp);
+            }
+        }
+
+        /// @brief Extend the file and the mapping to hold at least `n` elements.
+        void reserve(size_type n) {
+            if (m_capacity < n) {
+                remap(n);
+            }
+        }
+
+        /// @brief Shrink the file and the mapping to the pages of the elements.
+        void shrink_to_fit() {
+            if (mapped_bytes(m_size) != mapped_bytes(m_capacity)) {
+                remap(m_size);
+            }
+        }
+
+        /// @brief Write the dirty pages back to the file, wait for the writes unless `async`.
+        void sync(bool async = false) {
+            if (m_start != nullptr && msync(m_start, mapped_bytes(m_capacity), async ? MS_ASYNC : MS_SYNC) != 0) {
+                fail("mmap_vector: msync");
+            }
+        }
+
+        /// @brief Tell the kernel how the whole mapping is going to be accessed.
+        void advise(mmap_advice advice) {
+            advise(advice, begin(), end());
+        }
+
+        /// @brief Tell the kernel how the pages of [`first`, `last`) are going to be accessed.
+        void advise(mmap_advice advice, const_iterator first, const_iterator last) {
+            if (first == last) {
+                return;
+            }
+            // `madvise` takes a page aligned start.
+            static const int flags[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED, MADV_DONTNEED };
+            char* page_first         = (char*)((size_t)first & ~(page_bytes() - 1));
+            size_t bytes             = (const char*)last - page_first;
+            if (madvise(page_first, bytes, flags[advice]) != 0) {
+                fail("mmap_vector: madvise");
+            }
+        }
+
+        friend void swap(mmap_vector& lhs, mmap_vector& rhs) noexcept {
+            TinySTL::swap(lhs.m_fd, rhs.m_fd);
+            TinySTL::swap(lhs.m_start, rhs.m_start);
+            TinySTL::swap(lhs.m_size, rhs.m_size);
+            TinySTL::swap(lhs.m_capacity, rhs.m_capacity);
+        }
+
+    private:
+        template <typename InputIterator>
+        void append_aux(InputIterator first, InputIterator last, input_iterator_tag) {
+            for (; first != last; ++first) {
+                push_back(*first);
+            }
+        }
+
+        template <typename ForwardIterator>
+        void append_aux(ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+            const size_type n = TinySTL::distance(first, last);
+            TinySTL::copy(first, last, append_uninitialized(n));
+        }
+    };
+
+} // namespace TinySTL
+
+#endif // TINYSTL_HAS_MMAP
+
+#endif // !_TINYSTL_MMAP_VECTOR_HPP_
@@ -6,8 +6,13 @@
 
 namespace TinySTL {
 
+    template <typename Key, typename Value, typename Compare, typename Alloc>
+    class map;
+
     template <typename Key, typename Value, typename Compare = TinySTL::less<Key>, typename Alloc = alloc>
     class multimap {
+        friend class map<Key, Value, Compare, Alloc>;
+
     public:
         using key_type    = Key;
         using data_type   = Value;
@@ -16,7 +21,7 @@ namespace TinySTL {
         using key_compare = Compare;
 
         class value_compare : public binary_function<value_type, value_type, bool> {
-            friend class map<Key, Value, Compare, Alloc>;
+            friend class multimap<Key, Value, Compare, Alloc>;
 
         protected:
             Compare comp;
@@ -30,7 +35,7 @@ namespace TinySTL {
         };
 
     private:
-        using rep_type = rb_tree<key_type, value_type, select1st<value_type>, key_compare, Alloc>;
+        using rep_type = rbtree<key_type, value_type, select1st<value_type>, key_compare, Alloc>;
         rep_type t;
 
     public:
@@ -43,6 +48,7 @@ namespace TinySTL {
         using size_type       = typename rep_type::size_type;
         using difference_type = typename rep_type::difference_type;
         using allocator_type  = typename rep_type::allocator_type;
+        using node_type       = typename rep_type::node_type;
 
         multimap()
             : t(Compare(), allocator_type()) {}
@@ -73,12 +79,13 @@ namespace TinySTL {
         multimap(const multimap& x)
             : t(x.t) {}
 
-        multimap operator=(const multimap& x) {
+        multimap& operator=(const multimap& x) {
             t = x.t;
             return *this;
         }
 
     public:
+        allocator_type get_allocator() const { return t.get_allocator(); }
         key_compare key_comp() const { return t.key_comp(); }
         value_compare value_comp() const { return value_compare(t.key_comp()); }
 
@@ -89,7 +96,7 @@ namespace TinySTL {
         bool empty() const { return t.empty(); }
         size_type size() const { return t.size(); }
 
-        void swap(map& x) { t.swap(x.t); }
+        void swap(multimap& x) { t.swap(x.t); }
 
         iterator insert(const value_type& x) {
             return t.insert_equal(x);
@@ -121,6 +128,17 @@ namespace TinySTL {
 
         void clear() { t.clear(); }
 
+        /// @brief Take the node of `position` out of the multimap, its key can be changed before it is inserted again.
+        node_type extract(iterator position) { return t.extract(position); }
+        node_type extract(const key_type& x) { return t.extract(x); }
+
+        /// @brief Insert the node of `node` without allocating.
+        iterator insert(node_type&& node) { return t.insert_equal(std::move(node)); }
+
+        /// @brief Move all the entries of `source` by relinking their nodes.
+        void merge(multimap& source) { t.merge_equal(source.t); }
+        void merge(map<Key, Value, Compare, Alloc>& source) { t.merge_equal(source.t); }
+
         iterator find(const key_type& x) { return t.find(x); }
         const_iterator find(const key_type& x) const { return t.find(x); }
         size_type count(const key_type& x) const { return t.count(x); }
@@ -131,12 +149,12 @@ namespace TinySTL {
         TinySTL::pair<iterator, iterator> equal_range(const key_type& x) { return t.equal_range(x); }
         TinySTL::pair<const_iterator, const_iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
 
-        friend bool operator==(const map& lhs, const map& rhs) noexcept { return lhs.t == rhs.t; }
-        friend bool operator!=(const map& lhs, const map& rhs) noexcept { return !(lhs == rhs); }
-        friend bool operator<(const map& lhs, const map& rhs) noexcept { return lhs.t < rhs.t; }
-        friend bool operator>(const map& lhs, const map& rhs) noexcept { return rhs < lhs; }
-        friend bool operator<=(const map& lhs, const map& rhs) noexcept { return !(rhs < lhs); }
-        friend bool operator>=(const map& lhs, const map& rhs) noexcept { return !(lhs < rhs); }
+        friend bool operator==(const multimap& lhs, const multimap& rhs) noexcept { return lhs.t == rhs.t; }
+        friend bool operator!=(const multimap& lhs, const multimap& rhs) noexcept { return !(lhs == rhs); }
+        friend bool operator<(const multimap& lhs, const multimap& rhs) noexcept { return lhs.t < rhs.t; }
+        friend bool operator>(const multimap& lhs, const multimap& rhs) noexcept { return rhs < lhs; }
+        friend bool operator<=(const multimap& lhs, const multimap& rhs) noexcept { return !(rhs < lhs); }
+        friend bool operator>=(const multimap& lhs, const multimap& rhs) noexcept { return !(lhs < rhs); }
     };
 
 } // namespace TinySTL
@@ -0,0 +1,273 @@
+#ifndef _TINYSTL_NUMA_HPP_
+#define _TINYSTL_NUMA_HPP_
+
+#include <cstddef>
+#include <mutex>
+#include <stl_alloc.hpp>
+
+#if defined(__linux__)
+    #include <sched.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #ifdef TINYSTL_USE_LIBNUMA
+        #include <numa.h>
+        #include <numaif.h>
+    #endif
+#endif
+
+namespace TinySTL {
+
+#if defined(__linux__)
+
+    // Address space of the NUMA pools.
+    // One range of `RegionBytes` is reserved for every node at once, without backing memory,
+    // so the node owning a pointer is found by a subtraction and a division.
+    // Chunks are committed from the range of their node and bound to that node.
+    template <int MaxNodes, size_t RegionBytes>
+    class __numa_regions {
+    private:
+        // Chunks are committed in huge pages, so that they can be backed by transparent huge pages.
+        enum { _GRANULE = 2 * 1024 * 1024 };
+        // The calling thread checks its node again after this number of allocations.
+        enum { _NODE_REFRESH = 1024 };
+        // Memory policy of the chunks, `MPOL_PREFERRED` of <numaif.h>.
+        enum { _PREFERRED = 1 };
+
+        static_assert(RegionBytes % _GRANULE == 0, "RegionBytes should be a multiply of 2MB.");
+        static_assert(MaxNodes <= 64, "The node mask of mbind is an unsigned long.");
+
+        // Start of the reserved ranges, nullptr if the reservation failed.
+        static char* base;
+        static std::once_flag reserved;
+        // Next uncommitted byte of every range, only touched under the lock of the pool of that node.
+        static char* next[MaxNodes];
+
+        static void reserve() {
+            // One more granule for the alignment.
+            void* space = mmap(nullptr, MaxNodes * RegionBytes + _GRANULE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (space != MAP_FAILED) {
+                base = (char*)(((size_t)space + _GRANULE - 1) & ~((size_t)_GRANULE - 1));
+                for (int i = 0; i < MaxNodes; ++i) {
+                    next[i] = base + i * RegionBytes;
+                }
+            }
+        }
+
+        // Prefer `node` for the pages in [`first`, `first + bytes`), with or without libnuma.
+        // The other nodes are used when this one is full, a strict binding would fail the page fault instead.
+        // Failure is ignored, then the pages follow the default policy.
+        static void bind(char* first, size_t bytes, int node) {
+    #ifdef TINYSTL_USE_LIBNUMA
+            unsigned long mask = 1UL << node;
+            if (numa_available() != -1 && node <= numa_max_node()) {
+                mbind(first, bytes, _PREFERRED, &mask, sizeof(mask) * 8, 0);
+            }
+    #elif defined(SYS_mbind)
+            unsigned long mask = 1UL << node;
+            syscall(SYS_mbind, first, bytes, _PREFERRED, &mask, sizeof(mask) * 8, 0);
+    #else
+            (void)first, (void)bytes, (void)node;
+    #endif
+        }
+
+        static int query_node() {
+            int node = 0;
+    #ifdef TINYSTL_USE_LIBNUMA
+            if (numa_available() != -1) {
+                int cpu = sched_getcpu();
+                node    = cpu < 0 ? 0 : numa_node_of_cpu(cpu);
+            }
+    #elif defined(SYS_getcpu)
+            unsigned cpu = 0, n = 0;
+            if (syscall(SYS_getcpu, &cpu, &n, nullptr) == 0) {
+                node = (int)n;
+            }
+    #endif
+            return node < 0 ? 0 : node % MaxNodes;
+        }
+
+    public:
+        // Node of the calling thread, cached for `_NODE_REFRESH` calls.
+        // Always 0 if the reservation failed.
+        static int current_node() {
+            std::call_once(reserved, reserve);
+            if (base == nullptr) {
+                return 0;
+            }
+            static thread_local int node      = 0;
+            static thread_local unsigned left = 0;
+            if (left == 0) {
+                node = query_node();
+                left = _NODE_REFRESH;
+            }
+            --left;
+            return node;
+        }
+
+        // Node whose range contains `ptr`, 0 if none does.
+        static int owner(const void* ptr) {
+            if (base == nullptr || (const char*)ptr < base || (size_t)((const char*)ptr - base) >= MaxNodes * RegionBytes) {
+                return 0;
+            }
+            return (int)(((const char*)ptr - base) / RegionBytes);
+        }
+
+        // Commit at least `bytes` bytes from the range of `node`, nullptr if the range is used up.
+        static void* commit(int node, size_t& bytes) {
+            if (base == nullptr) {
+                return malloc(bytes);
+            }
+            bytes        = (bytes + _GRANULE - 1) & ~((size_t)_GRANULE - 1);
+            char* first  = next[node];
+            char* region = base + node * RegionBytes;
+            if ((size_t)(first - region) + bytes > RegionBytes || mprotect(first, bytes, PROT_READ | PROT_WRITE) != 0) {
+                return nullptr;
+            }
+            bind(first, bytes, node);
+    #ifdef MADV_HUGEPAGE
+            madvise(first, bytes, MADV_HUGEPAGE);
+    #endif
+            next[node] = first + bytes;
+            return first;
+        }
+
+        // Give the pages back to the system, the address range stays reserved and is not reused.
+        static void decommit(void* ptr, size_t bytes) {
+            if (base == nullptr) {
+                free(ptr);
+                return;
+            }
+            mmap(ptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+        }
+    };
+
+    template <int MaxNodes, size_t RegionBytes>
+    char* __numa_regions<MaxNodes, RegionBytes>::base = nullptr;
+
+    template <int MaxNodes, size_t RegionBytes>
+    std::once_flag __numa_regions<MaxNodes, RegionBytes>::reserved;
+
+    template <int MaxNodes, size_t RegionBytes>
+    char* __numa_regions<MaxNodes, RegionBytes>::next[MaxNodes];
+
+    // Chunks committed from the range of `Node` in `Regions`.
+    template <int Node, typename Regions>
+    struct __numa_chunk_source {
+        static void* try_allocate(size_t& bytes) { return Regions::commit(Node, bytes); }
+
+        static void* allocate(size_t& bytes) {
+            void* space = try_allocate(bytes);
+            if (space == nullptr) {
+                std::cerr << "Out of memory.\n";
+                exit(1);
+            }
+            return space;
+        }
+
+        static void deallocate(void* ptr, size_t bytes) { Regions::decommit(ptr, bytes); }
+    };
+
+    // Entry points of the pool of one node.
+    struct __numa_pool_ops {
+        void* (*allocate)(size_t);
+        void (*deallocate)(void*, size_t);
+        void (*deallocate_chain)(void*, void*, size_t, size_t);
+        void* (*reallocate)(void*, size_t, size_t);
+        size_t (*trim)();
+    };
+
+    // Fill the entries of the pools of nodes [0, `Node`).
+    template <template <int> class Pool, int Node>
+    struct __numa_pool_table {
+        static void fill(__numa_pool_ops* table) {
+            __numa_pool_table<Pool, Node - 1>::fill(table);
+            table[Node - 1] = { &Pool<Node - 1>::allocate, &Pool<Node - 1>::deallocate, &Pool<Node - 1>::deallocate_chain, &Pool<Node - 1>::reallocate, &Pool<Node - 1>::trim };
+        }
+    };
+
+    template <template <int> class Pool>
+    struct __numa_pool_table<Pool, 0> {
+        static void fill(__numa_pool_ops*) {}
+    };
+
+    // NUMA-aware secondary allocator.
+    // It keeps one `__default_alloc_template` per node, whose chunks are bound to that node.
+    // Allocation uses the pool of the node of the calling thread,
+    // deallocation returns the object to the pool it came from.
+    // Nodes beyond `MaxNodes` share the pools modulo `MaxNodes`.
+    // On a single node machine, or if the address space cannot be reserved, only the pool of node 0 is used.
+    // With `TINYSTL_USE_LIBNUMA`, libnuma is used to find and bind the nodes, otherwise `getcpu` and `mbind`.
+    template <bool threads, int inst, typename SizeClass = __linear_size_class<>, typename RefillPolicy = __adaptive_refill_policy<>, int MaxNodes = 8, size_t RegionBytes = (size_t)64 << 30>
+    class __numa_alloc_template {
+    private:
+        using regions = __numa_regions<MaxNodes, RegionBytes>;
+
+        template <int Node>
+        using pool = __default_alloc_template<threads, inst, SizeClass, RefillPolicy, __numa_chunk_source<Node, regions>>;
+
+        static const __numa_pool_ops* pools() {
+            struct table {
+                __numa_pool_ops ops[MaxNodes];
+                table() { __numa_pool_table<pool, MaxNodes>::fill(ops); }
+            };
+            static const table t;
+            return t.ops;
+        }
+
+    public:
+        static void* allocate(size_t n) { return pools()[regions::current_node()].allocate(n); }
+
+        static void deallocate(void* ptr, size_t n) { pools()[regions::owner(ptr)].deallocate(ptr, n); }
+
+        // The chain may mix the nodes, every object is returned to its own pool.
+        static void deallocate_chain(void* head, void* tail, size_t count, size_t n) {
+            const __numa_pool_ops* ops = pools();
+            // Cut the chain into runs of the same node.
+            while (count != 0) {
+                int node     = regions::owner(head);
+                void* last   = head;
+                size_t run   = 1;
+                void* next   = *(void**)last;
+                while (run < count && regions::owner(next) == node) {
+                    last = next;
+                    next = *(void**)last;
+                    ++run;
+                }
+                ops[node].deallocate_chain(head, last, run, n);
+                head = next;
+                count -= run;
+            }
+            (void)tail;
+        }
+
+        static void* reallocate(void* ptr, size_t old_size, size_t new_size) { return pools()[regions::owner(ptr)].reallocate(ptr, old_size, new_size); }
+
+        // Trim the pools of all the nodes, return the number of bytes released.
+        static size_t trim() {
+            size_t released = 0;
+            for (int i = 0; i < MaxNodes; ++i) {
+                released += pools()[i].trim();
+            }
+            return released;
+        }
+
+        // Node of the calling thread.
+        static int current_node() { return regions::current_node(); }
+    };
+
+#else
+
+    // No NUMA support, a plain secondary allocator.
+    template <bool threads, int inst, typename SizeClass = __linear_size_class<>, typename RefillPolicy = __adaptive_refill_policy<>, int MaxNodes = 8, size_t RegionBytes = (size_t)64 << 30>
+    class __numa_alloc_template : public __default_alloc_template<threads, inst, SizeClass, RefillPolicy> {
+    public:
+        static int current_node() { return 0; }
+    };
+
+#endif
+
+    using numa_alloc = __numa_alloc_template<true, 0>;
+
+} // namespace TinySTL
+
+#endif // !_TINYSTL_NUMA_HPP_
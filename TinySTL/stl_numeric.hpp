@@ -2,23 +2,52 @@
 #define _TINYSTL_NUMERIC_HPP_
 
 #include <stl_function.hpp>
+#include <stl_iterator.hpp>
 
 namespace TinySTL {
 
-    template <typename InputIterator, typename T>
-    constexpr T accumulate(InputIterator first, InputIterator last, T init) {
+    template <typename InputIterator, typename T, typename BinaryOperator>
+    constexpr T accumulate(InputIterator first, InputIterator last, T init, BinaryOperator op);
+
+    template <typename InputIterator, typename T, typename BinaryOperator>
+    T __accumulate(InputIterator first, InputIterator last, T init, BinaryOperator op, __false_type) {
         for (; first != last; ++first) {
-            init = init + *first;
+            init = op(init, *first);
         }
         return init;
     }
 
+    // Segmented iterator version, accumulate segment by segment.
     template <typename InputIterator, typename T, typename BinaryOperator>
-    constexpr T accumulate(InputIterator first, InputIterator last, T init, BinaryOperator op) {
-        for (; first != last; ++first) {
-            init = op(init, *first);
+    T __accumulate(InputIterator first, InputIterator last, T init, BinaryOperator op, __true_type) {
+        using traits = __segmented_iterator_traits<InputIterator>;
+        auto first_segment = traits::segment(first);
+        auto last_segment  = traits::segment(last);
+        if (first_segment == last_segment) {
+            return TinySTL::accumulate(traits::local(first), traits::local(last), init, op);
         }
-        return init;
+        init = TinySTL::accumulate(traits::local(first), traits::end(first_segment), init, op);
+        for (++first_segment; first_segment != last_segment; ++first_segment) {
+            init = TinySTL::accumulate(traits::begin(first_segment), traits::end(first_segment), init, op);
+        }
+        return TinySTL::accumulate(traits::begin(last_segment), traits::local(last), init, op);
+    }
+
+    // `init + value`, as the plain `accumulate` adds.
+    struct __accumulate_plus {
+        template <typename T, typename U>
+        T operator()(const T& init, const U& value) const { return init + value; }
+    };
+
+    template <typename InputIterator, typename T>
+    constexpr T accumulate(InputIterator first, InputIterator last, T init) {
+        return TinySTL::accumulate(first, last, init, __accumulate_plus());
+    }
+
+    template <typename InputIterator, typename T, typename BinaryOperator>
+    constexpr T accumulate(InputIterator first, InputIterator last, T init, BinaryOperator op) {
+        using segmented = typename __segmented_iterator_traits<InputIterator>::is_segmented;
+        return __accumulate(first, last, init, op, segmented());
     }
 
     template <typename InputIterator, typename OutputIterator>
@@ -10,6 +10,17 @@ namespace TinySTL {
 
         T1 first{};
         T2 second{};
+
+        pair() = default;
+
+        pair(const T1& a, const T2& b)
+            : first(a)
+            , second(b) {}
+
+        template <typename U1, typename U2>
+        pair(const pair<U1, U2>& other)
+            : first(other.first)
+            , second(other.second) {}
     };
 
     template <typename T1, typename T2>
@@ -22,6 +33,31 @@ namespace TinySTL {
         return p1.first == p2.first && p1.second == p2.second;
     }
 
+    template <typename T1, typename T2>
+    inline bool operator!=(const pair<T1, T2>& p1, const pair<T1, T2>& p2) {
+        return !(p1 == p2);
+    }
+
+    template <typename T1, typename T2>
+    inline bool operator<(const pair<T1, T2>& p1, const pair<T1, T2>& p2) {
+        return p1.first < p2.first || (!(p2.first < p1.first) && p1.second < p2.second);
+    }
+
+    template <typename T1, typename T2>
+    inline bool operator>(const pair<T1, T2>& p1, const pair<T1, T2>& p2) {
+        return p2 < p1;
+    }
+
+    template <typename T1, typename T2>
+    inline bool operator<=(const pair<T1, T2>& p1, const pair<T1, T2>& p2) {
+        return !(p2 < p1);
+    }
+
+    template <typename T1, typename T2>
+    inline bool operator>=(const pair<T1, T2>& p1, const pair<T1, T2>& p2) {
+        return !(p1 < p2);
+    }
+
 } // namespace TinySTL
 
 #endif // !_TINYSTL_PAIR_HPP_
@@ -6,8 +6,13 @@
 
 namespace TinySTL {
 
+    template <typename Key, typename Compare, typename Alloc>
+    class multiset;
+
     template <typename Key, typename Compare = TinySTL::less<Key>, typename Alloc = alloc>
     class set {
+        friend class multiset<Key, Compare, Alloc>;
+
     public:
         using key_type      = Key;
         using value_type    = Key;
@@ -15,7 +20,7 @@ namespace TinySTL {
         using value_compare = Compare;
 
     private:
-        using rep_type = rb_tree<key_type, value_type, identity<value_type>, key_compare, Alloc>;
+        using rep_type = rbtree<key_type, value_type, identity<value_type>, key_compare, Alloc>;
         rep_type t;
 
     public:
@@ -28,6 +33,7 @@ namespace TinySTL {
         using size_type       = typename rep_type::size_type;
         using difference_type = typename rep_type::difference_type;
         using allocator_type  = typename rep_type::allocator_type;
+        using node_type       = typename rep_type::node_type;
 
         set()
             : t(Compare(), allocator_type()) {}
@@ -64,6 +70,7 @@ namespace TinySTL {
         }
 
     public:
+        allocator_type get_allocator() const { return t.get_allocator(); }
         key_compare key_comp() const { return t.key_comp(); }
         value_compare value_comp() const { return t.key_comp(); }
 
@@ -108,18 +115,35 @@ namespace TinySTL {
 
         void clear() { t.clear(); }
 
+        /// @brief Take the node of `position` out of the set, its value can be changed before it is inserted again.
+        node_type extract(iterator position) {
+            using rep_iterator = typename rep_type::iterator;
+            return t.extract(rep_iterator(static_cast<typename rep_iterator::link_type>(position.m_node)));
+        }
+        node_type extract(const key_type& key) { return t.extract(key); }
+
+        /// @brief Insert the node of `node` without allocating, it stays in `node` if the value is taken.
+        TinySTL::pair<iterator, bool> insert(node_type&& node) {
+            TinySTL::pair<typename rep_type::iterator, bool> p = t.insert_unique(std::move(node));
+            return TinySTL::pair<iterator, bool>(p.first, p.second);
+        }
+
+        /// @brief Move the values of `source` which are not in this set by relinking their nodes.
+        void merge(set& source) { t.merge_unique(source.t); }
+        void merge(multiset<Key, Compare, Alloc>& source) { t.merge_unique(source.t); }
+
         iterator find(const key_type& key) const { return t.find(key); }
         size_type count(const key_type& key) const { return t.count(key); }
         iterator lower_bound(const key_type& key) const { return t.lower_bound(key); }
         iterator upper_bound(const key_type& key) const { return t.upper_bound(key); }
         TinySTL::pair<iterator, iterator> equal_range(const key_type& key) const { return t.equal_range(key); }
 
-        friend bool operator==(const map& lhs, const map& rhs) noexcept { return lhs.t == rhs.t; }
-        friend bool operator!=(const map& lhs, const map& rhs) noexcept { return !(lhs == rhs); }
-        friend bool operator<(const map& lhs, const map& rhs) noexcept { return lhs.t < rhs.t; }
-        friend bool operator>(const map& lhs, const map& rhs) noexcept { return rhs < lhs; }
-        friend bool operator<=(const map& lhs, const map& rhs) noexcept { return !(rhs < lhs); }
-        friend bool operator>=(const map& lhs, const map& rhs) noexcept { return !(lhs < rhs); }
+        friend bool operator==(const set& lhs, const set& rhs) noexcept { return lhs.t == rhs.t; }
+        friend bool operator!=(const set& lhs, const set& rhs) noexcept { return !(lhs == rhs); }
+        friend bool operator<(const set& lhs, const set& rhs) noexcept { return lhs.t < rhs.t; }
+        friend bool operator>(const set& lhs, const set& rhs) noexcept { return rhs < lhs; }
+        friend bool operator<=(const set& lhs, const set& rhs) noexcept { return !(rhs < lhs); }
+        friend bool operator>=(const set& lhs, const set& rhs) noexcept { return !(lhs < rhs); }
     };
 
 } // namespace TinySTL
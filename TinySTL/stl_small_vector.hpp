@@ -0,0 +1,438 @@
+#ifndef _TINYSTL_SMALL_VECTOR_HPP_
+#define _TINYSTL_SMALL_VECTOR_HPP_
+
+#include <utility>
+#include <stl_vector.hpp>
+
+namespace TinySTL {
+
+    // Vector with a small buffer.
+    // Up to `N` elements are kept in the object itself, so a short vector costs no allocation
+    // and its elements are next to its pointers.
+    // After that the elements spill to `Alloc` and it grows like `vector`, by `GrowthPolicy`.
+    // Moving or swapping a small vector moves the inlined elements one by one.
+    template <typename T, size_t N, typename Alloc = alloc, typename GrowthPolicy = __geometric_growth_policy<>>
+    class small_vector : private simple_alloc<T, Alloc> {
+        static_assert(N > 0, "The inline capacity should be larger than 0.");
+
+    public:
+        using value_type       = T;
+        using pointer          = T*;
+        using iterator         = T*;
+        using reference        = T&;
+        using size_type        = size_t;
+        using difference_type  = std::ptrdiff_t;
+        using const_pointer    = const T*;
+        using const_iterator   = const T*;
+        using const_reference  = const T&;
+        using vector_allocator = simple_alloc<T, Alloc>;
+        using allocator_type   = Alloc;
+
+    protected:
+        // m_start position of used, points to `m_buffer` while inlined
+        iterator m_start;
+        // end position of used
+        iterator m_finish;
+        // end position of all space
+        iterator m_end_of_storage;
+        // inline space of `N` elements
+        alignas(T) unsigned char m_buffer[N * sizeof(T)];
+
+    protected:
+        iterator buffer() { return reinterpret_cast<iterator>(m_buffer); }
+        const_iterator buffer() const { return reinterpret_cast<const_iterator>(m_buffer); }
+
+        /// @brief: Start with the empty inline space.
+        void reset() {
+            m_start          = buffer();
+            m_finish         = buffer();
+            m_end_of_storage = buffer() + N;
+        }
+
+        /// @brief: Give back the allocated space, nothing to do while inlined.
+        void deallocate_storage() {
+            if (!is_inline()) {
+                vector_allocator::deallocate(m_start, capacity());
+            }
+        }
+
+        /// @brief: Capacity after growing to hold `n` more elements.
+        size_type grown_capacity(size_type n) const {
+            return GrowthPolicy::next(capacity(), size() + n);
+        }
+
+        /// @brief: Move the elements to an allocated space of `new_capacity`.
+        void grow_to(size_type new_capacity) {
+            // Already spilled, the elements can be relocated by `Alloc::reallocate`.
+            if (!is_inline() && __is_trivially_relocatable<T>::value) {
+                const size_type old_size = size();
+                m_start                  = vector_allocator::reallocate(m_start, capacity(), new_capacity);
+                m_finish                 = m_start + old_size;
+                m_end_of_storage         = m_start + new_capacity;
+                return;
+            }
+            iterator new_start  = vector_allocator::allocate(new_capacity);
+            iterator new_finish = new_start;
+            try {
+                new_finish = TinySTL::uninitialized_move_if_noexcept(m_start, m_finish, new_start);
+            }
+            catch (const std::exception&) {
+                vector_allocator::deallocate(new_start, new_capacity);
+                throw;
+            }
+            destory(m_start, m_finish);
+            deallocate_storage();
+            m_start          = new_start;
+            m_finish         = new_finish;
+            m_end_of_storage = new_start + new_capacity;
+        }
+
+        /// @brief: Make room for `n` more elements.
+        void reserve_more(size_type n) {
+            if ((size_type)(m_end_of_storage - m_finish) < n) {
+                grow_to(grown_capacity(n));
+            }
+        }
+
+        /// @brief: Take the elements of `other`, the space of `this` is empty and inlined.
+        void steal(small_vector& other) {
+            // Take the allocated space.
+            if (!other.is_inline()) {
+                m_start          = other.m_start;
+                m_finish         = other.m_finish;
+                m_end_of_storage = other.m_end_of_storage;
+            }
+            // Move the inlined elements.
+            else {
+                m_finish = TinySTL::uninitialized_move_if_noexcept(other.m_start, other.m_finish, m_start);
+                destory(other.m_start, other.m_finish);
+            }
+            other.reset();
+        }
+
+        template <typename Integer>
+        void insert_dispatch(iterator pos, Integer n, Integer value, __true_type) {
+            insert(pos, (size_type)n, (T)value);
+        }
+
+        template <typename InputIterator>
+        void insert_dispatch(iterator pos, InputIterator first, InputIterator last, __false_type) {
+            range_insert(pos, first, last, iterator_category(first));
+        }
+
+        /// @brief: Insert an input range, collect the elements first if not at the end.
+        template <typename InputIterator>
+        void range_insert(iterator pos, InputIterator first, InputIterator last, input_iterator_tag) {
+            if (pos == end()) {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            }
+            else {
+                small_vector temp(get_allocator());
+                temp.range_insert(temp.end(), first, last, input_iterator_tag());
+                range_insert(pos, temp.begin(), temp.end(), forward_iterator_tag());
+            }
+        }
+
+        /// @brief: Insert a forward range, grow at most once.
+        template <typename ForwardIterator>
+        void range_insert(iterator pos, ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+            const size_type n = TinySTL::distance(first, last);
+            if (n == 0) {
+                return;
+            }
+            const size_type offset = pos - m_start;
+            reserve_more(n);
+            pos = m_start + offset;
+
+            const size_type n_elems_after = m_finish - pos;
+            iterator old_finish           = m_finish;
+            if (n_elems_after > n) {
+                // Move [`m_finish - n`, `m_finish`) to [`m_finish`, `m_finish + n`).
+                m_finish = TinySTL::uninitialized_move_if_noexcept(m_finish - n, m_finish, m_finish);
+                // Move [`pos`, `old_finish - n`) to [`pos + n`, `old_finish`).
+                TinySTL::move_backward(pos, old_finish - n, old_finish);
+                TinySTL::copy(first, last, pos);
+            }
+            else {
+                ForwardIterator mid = first;
+                TinySTL::advance(mid, n_elems_after);
+                // Copy [`mid`, `last`) to [`m_finish`, `pos + n`).
+                m_finish = TinySTL::uninitialized_copy(mid, last, m_finish);
+                // Move [`pos`, `old_finish`) to [`pos + n`, `old_finish + n`).
+                m_finish = TinySTL::uninitialized_move_if_noexcept(pos, old_finish, m_finish);
+                TinySTL::copy(first, mid, pos);
+            }
+        }
+
+    public:
+        small_vector() {
+            reset();
+        }
+
+        explicit small_vector(const Alloc& a)
+            : vector_allocator(a) {
+            reset();
+        }
+
+        small_vector(size_type n, const T& value = value_type(), const Alloc& a = Alloc())
+            : vector_allocator(a) {
+            reset();
+            insert(end(), n, value);
+        }
+
+        small_vector(const small_vector& other)
+            : vector_allocator(other.get_allocator()) {
+            reset();
+            insert(end(), other.begin(), other.end());
+        }
+
+        small_vector(small_vector&& other) noexcept
+            : vector_allocator(other.get_allocator()) {
+            reset();
+            steal(other);
+        }
+
+        /// @brief Construct from [`first`, `last`), or `first` copies of `last` if they are integers.
+        template <typename InputIterator>
+        small_vector(InputIterator first, InputIterator last, const Alloc& a = Alloc())
+            : vector_allocator(a) {
+            reset();
+            insert(end(), first, last);
+        }
+
+        small_vector& operator=(const small_vector& other) {
+            if (this != &other) {
+                small_vector temp(other);
+                swap(*this, temp);
+            }
+            return *this;
+        }
+
+        // The allocator comes along with the elements, as in `vector`,
+        // since an allocated space has to go back to the allocator it came from.
+        small_vector& operator=(small_vector&& other) noexcept {
+            if (this != &other) {
+                clear();
+                deallocate_storage();
+                static_cast<vector_allocator&>(*this) = static_cast<vector_allocator&>(other);
+                reset();
+                steal(other);
+            }
+            return *this;
+        }
+
+        ~small_vector() {
+            clear();
+            deallocate_storage();
+        }
+
+    public:
+        allocator_type get_allocator() const { return vector_allocator::get_allocator(); }
+
+        iterator begin() { return m_start; }
+        iterator end() { return m_finish; }
+        const_iterator begin() const { return m_start; }
+        const_iterator end() const { return m_finish; }
+        const_iterator cbegin() const { return m_start; }
+        const_iterator cend() const { return m_finish; }
+
+        size_type size() const { return (size_type)(end() - begin()); }
+        size_type capacity() const { return (size_type)(m_end_of_storage - begin()); }
+        bool empty() const { return begin() == end(); }
+        // Whether the elements are in the inline space.
+        bool is_inline() const { return m_start == buffer(); }
+
+        reference front() { return *begin(); }
+        reference back() { return *(end() - 1); }
+        reference operator[](size_type idx) { return *(begin() + idx); }
+        const_reference front() const { return *begin(); }
+        const_reference back() const { return *(end() - 1); }
+        const_reference operator[](size_type idx) const { return *(begin() + idx); }
+
+    public:
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
+        /// @brief Construct a value from `args` at the back of the vector.
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            if (m_finish == m_end_of_storage) {
+                // Construct the value first, since `args` may refer to an element of this vector.
+                T value(std::forward<Args>(args)...);
+                grow_to(grown_capacity(1));
+                construct(m_finish, std::move(value));
+            }
+            else {
+                construct(m_finish, std::forward<Args>(args)...);
+            }
+            ++m_finish;
+            return back();
+        }
+
+        /// @brief Construct a value from `args` at given `pos`.
+        template <typename... Args>
+        iterator emplace(iterator pos, Args&&... args) {
+            const size_type offset = pos - begin();
+            if (pos == end()) {
+                emplace_back(std::forward<Args>(args)...);
+            }
+            else {
+                T value(std::forward<Args>(args)...);
+                reserve_more(1);
+                pos = m_start + offset;
+                construct(m_finish, std::move(*(m_finish - 1)));
+                ++m_finish;
+                TinySTL::move_backward(pos, m_finish - 2, m_finish - 1);
+                *pos = std::move(value);
+            }
+            return begin() + offset;
+        }
+
+        iterator insert(iterator pos, const T& value) {
+            return emplace(pos, value);
+        }
+
+        iterator insert(iterator pos, T&& value) {
+            return emplace(pos, std::move(value));
+        }
+
+        /// @brief Insert `n` copies of `x` at given `pos`.
+        void insert(iterator pos, size_type n, const T& x) {
+            if (n == 0) {
+                return;
+            }
+            // Copy `x` first, since it may refer to an element of this vector.
+            T value(x);
+            const size_type offset = pos - m_start;
+            reserve_more(n);
+            pos = m_start + offset;
+
+            const size_type n_elems_after = m_finish - pos;
+            iterator old_finish           = m_finish;
+            if (n_elems_after > n) {
+                m_finish = TinySTL::uninitialized_move_if_noexcept(m_finish - n, m_finish, m_finish);
+                TinySTL::move_backward(pos, old_finish - n, old_finish);
+                TinySTL::fill(pos, pos + n, value);
+            }
+            else {
+                m_finish = TinySTL::uninitialized_fill_n(m_finish, n - n_elems_after, value);
+                m_finish = TinySTL::uninitialized_move_if_noexcept(pos, old_finish, m_finish);
+                TinySTL::fill(pos, old_finish, value);
+            }
+        }
+
+        /// @brief Insert [`first`, `last`), or `first` copies of `last` if they are integers.
+        template <typename InputIterator>
+        void insert(iterator pos, InputIterator first, InputIterator last) {
+            using integral = typename __is_integer<InputIterator>::integral;
+            insert_dispatch(pos, first, last, integral());
+        }
+
+        void pop_back() {
+            --m_finish;
+            destory(m_finish);
+        }
+
+        iterator erase(iterator pos) {
+            if (pos + 1 != end()) {
+                TinySTL::move(pos + 1, m_finish, pos);
+            }
+            pop_back();
+            return pos;
+        }
+
+        iterator erase(iterator first, iterator last) {
+            // Moving the tail onto itself may empty the elements.
+            if (first == last) {
+                return first;
+            }
+            iterator new_finish = TinySTL::move(last, m_finish, first);
+            destory(new_finish, m_finish);
+            m_finish = new_finish;
+            return first;
+        }
+
+        void clear() {
+            erase(begin(), end());
+        }
+
+        void resize(size_type new_size, const T& value = value_type()) {
+            if (new_size < size()) {
+                erase(begin() + new_size, end());
+            }
+            else {
+                insert(end(), new_size - size(), value);
+            }
+        }
+
+        /// @brief Allocate space for at least `n` elements, nothing to do if `n` fits inline.
+        void reserve(size_type n) {
+            if (capacity() < n) {
+                grow_to(n);
+            }
+        }
+
+        /// @brief Give back the unused capacity, move the elements back inline if they fit.
+        void shrink_to_fit() {
+            if (is_inline() || size() == capacity()) {
+                return;
+            }
+            small_vector temp(get_allocator());
+            if (size() > N) {
+                temp.grow_to(size());
+            }
+            temp.m_finish = TinySTL::uninitialized_move_if_noexcept(m_start, m_finish, temp.m_start);
+            swap(*this, temp);
+        }
+
+        friend void swap(small_vector& lhs, small_vector& rhs) noexcept {
+            // Both allocated, swap the pointers.
+            if (!lhs.is_inline() && !rhs.is_inline()) {
+                TinySTL::swap(static_cast<vector_allocator&>(lhs), static_cast<vector_allocator&>(rhs));
+                TinySTL::swap(lhs.m_start, rhs.m_start);
+                TinySTL::swap(lhs.m_finish, rhs.m_finish);
+                TinySTL::swap(lhs.m_end_of_storage, rhs.m_end_of_storage);
+            }
+            // Inlined elements have to be moved, the move assignments swap the allocators.
+            else {
+                small_vector temp(std::move(lhs));
+                lhs = std::move(rhs);
+                rhs = std::move(temp);
+            }
+        }
+
+        friend bool operator==(const small_vector& lhs, const small_vector& rhs) noexcept {
+            return lhs.size() == rhs.size() && TinySTL::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator!=(const small_vector& lhs, const small_vector& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const small_vector& lhs, const small_vector& rhs) noexcept {
+            return TinySTL::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+        friend bool operator>(const small_vector& lhs, const small_vector& rhs) noexcept {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const small_vector& lhs, const small_vector& rhs) noexcept {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const small_vector& lhs, const small_vector& rhs) noexcept {
+            return !(lhs < rhs);
+        }
+    };
+
+} // namespace TinySTL
+
+#endif // !_TINYSTL_SMALL_VECTOR_HPP_
@@ -119,10 +119,8 @@ namespace TinySTL {
         using link_type = rbtree_node<T>*;
 
         rbtree_iterator() = default;
-        rbtree_iterator(link_type x)
-            : m_node(x) {}
-        rbtree_iterator(const iterator& other)
-            : m_node(other.m_node) {}
+        rbtree_iterator(link_type x) { m_node = x; }
+        rbtree_iterator(const iterator& other) { m_node = other.m_node; }
 
         reference operator*() const { return link_type(m_node)->data; }
         pointer operator->() const { return &(operator*()); }
@@ -185,6 +183,7 @@ namespace TinySTL {
         if (y->left != nullptr) {
             y->left->parent = x;
         }
+        y->parent = x->parent;
         if (x == root) {
             root = y;
         }
@@ -220,6 +219,7 @@ namespace TinySTL {
         if (y->right != nullptr) {
             y->right->parent = x;
         }
+        y->parent = x->parent;
         if (x == root) {
             root = y;
         }
@@ -300,16 +300,248 @@ namespace TinySTL {
         root->color = rbtree_black;
     }
 
-    inline void rbtree_rebalance_for_erase(rbtree_node_base* x, rbtree_node_base*& root, rbtree_node_base*& leftmost, rbtree_node_base*& rightmost) {
+    // Unlink `z` from the tree and rebalance the tree.
+    // Return the node to be destroyed, which is always `z`.
+    inline rbtree_node_base* rbtree_rebalance_for_erase(rbtree_node_base* z, rbtree_node_base*& root, rbtree_node_base*& leftmost, rbtree_node_base*& rightmost) {
+        // `y` is the node to be unlinked from its position, `x` takes its position.
+        rbtree_node_base* y        = z;
+        rbtree_node_base* x        = nullptr;
+        rbtree_node_base* x_parent = nullptr;
+
+        // `z` has at most one child, `y` is `z`.
+        if (y->left == nullptr) {
+            x = y->right;
+        }
+        else if (y->right == nullptr) {
+            x = y->left;
+        }
+        // `z` has two children, `y` is the successor of `z`, and `y` has no left child.
+        else {
+            y = rbtree_node_base::s_minimum(y->right);
+            x = y->right;
+        }
+
+        // Relink `y` in place of `z`.
+        if (y != z) {
+            z->left->parent = y;
+            y->left         = z->left;
+            if (y != z->right) {
+                x_parent = y->parent;
+                if (x != nullptr) {
+                    x->parent = y->parent;
+                }
+                y->parent->left  = x;
+                y->right         = z->right;
+                z->right->parent = y;
+            }
+            else {
+                x_parent = y;
+            }
+            if (root == z) {
+                root = y;
+            }
+            else if (z->parent->left == z) {
+                z->parent->left = y;
+            }
+            else {
+                z->parent->right = y;
+            }
+            y->parent = z->parent;
+            // `y` takes the color of `z`, and `z` takes the color of the unlinked position.
+            TinySTL::swap(y->color, z->color);
+            y = z;
+        }
+        // Link `x` in place of `z`.
+        else {
+            x_parent = y->parent;
+            if (x != nullptr) {
+                x->parent = y->parent;
+            }
+            if (root == z) {
+                root = x;
+            }
+            else if (z->parent->left == z) {
+                z->parent->left = x;
+            }
+            else {
+                z->parent->right = x;
+            }
+            if (leftmost == z) {
+                leftmost = z->right == nullptr ? z->parent : rbtree_node_base::s_minimum(x);
+            }
+            if (rightmost == z) {
+                rightmost = z->left == nullptr ? z->parent : rbtree_node_base::s_maximum(x);
+            }
+        }
+
+        // A black node was unlinked, `x` carries an extra black.
+        if (y->color != rbtree_red) {
+            while (x != root && (x == nullptr || x->color == rbtree_black)) {
+                if (x == x_parent->left) {
+                    // `w` is the sibling of `x`.
+                    rbtree_node_base* w = x_parent->right;
+                    // Red sibling, rotate to get a black sibling.
+                    if (w->color == rbtree_red) {
+                        w->color        = rbtree_black;
+                        x_parent->color = rbtree_red;
+                        rbtree_rotate_left(x_parent, root);
+                        w = x_parent->right;
+                    }
+                    // Black sibling with black children, move the extra black up.
+                    if ((w->left == nullptr || w->left->color == rbtree_black) && (w->right == nullptr || w->right->color == rbtree_black)) {
+                        w->color = rbtree_red;
+                        x        = x_parent;
+                        x_parent = x_parent->parent;
+                    }
+                    else {
+                        // Black sibling with red left child, rotate to get a red right child.
+                        if (w->right == nullptr || w->right->color == rbtree_black) {
+                            w->left->color = rbtree_black;
+                            w->color       = rbtree_red;
+                            rbtree_rotate_right(w, root);
+                            w = x_parent->right;
+                        }
+                        // Black sibling with red right child, rotate to remove the extra black.
+                        w->color        = x_parent->color;
+                        x_parent->color = rbtree_black;
+                        if (w->right != nullptr) {
+                            w->right->color = rbtree_black;
+                        }
+                        rbtree_rotate_left(x_parent, root);
+                        break;
+                    }
+                }
+                else {
+                    rbtree_node_base* w = x_parent->left;
+                    if (w->color == rbtree_red) {
+                        w->color        = rbtree_black;
+                        x_parent->color = rbtree_red;
+                        rbtree_rotate_right(x_parent, root);
+                        w = x_parent->left;
+                    }
+                    if ((w->right == nullptr || w->right->color == rbtree_black) && (w->left == nullptr || w->left->color == rbtree_black)) {
+                        w->color = rbtree_red;
+                        x        = x_parent;
+                        x_parent = x_parent->parent;
+                    }
+                    else {
+                        if (w->left == nullptr || w->left->color == rbtree_black) {
+                            w->right->color = rbtree_black;
+                            w->color        = rbtree_red;
+                            rbtree_rotate_left(w, root);
+                            w = x_parent->left;
+                        }
+                        w->color        = x_parent->color;
+                        x_parent->color = rbtree_black;
+                        if (w->left != nullptr) {
+                            w->left->color = rbtree_black;
+                        }
+                        rbtree_rotate_right(x_parent, root);
+                        break;
+                    }
+                }
+            }
+            if (x != nullptr) {
+                x->color = rbtree_black;
+            }
+        }
+        return y;
     }
 
+    // Owns a node taken out of a `rbtree` by `extract`, until it is inserted into a tree or the handle is destroyed.
+    // The value can be changed in the handle, also the key of a map, so re-keying an entry costs no allocation.
+    // A node can only be inserted into a tree whose allocator can free it.
+    template <typename Value, typename Alloc>
+    class rbtree_node_handle : private simple_alloc<rbtree_node<Value>, Alloc> {
+        using node_allocator = simple_alloc<rbtree_node<Value>, Alloc>;
+        using link_type      = rbtree_node<Value>*;
+
+        template <typename, typename, typename, typename, typename>
+        friend class rbtree;
+
+    public:
+        using value_type     = Value;
+        using allocator_type = Alloc;
+
+    private:
+        link_type m_node;
+
+        rbtree_node_handle(link_type node, const allocator_type& a)
+            : node_allocator(a)
+            , m_node(node) {}
+
+        /// @brief: Give up the node to a tree.
+        link_type release() {
+            link_type node = m_node;
+            m_node         = nullptr;
+            return node;
+        }
+
+        /// @brief: Destroy and free the owned node.
+        void reset() {
+            if (m_node != nullptr) {
+                destory(&m_node->data);
+                node_allocator::deallocate(m_node, 1);
+                m_node = nullptr;
+            }
+        }
+
+    public:
+        rbtree_node_handle()
+            : m_node(nullptr) {}
+
+        rbtree_node_handle(const rbtree_node_handle&)            = delete;
+        rbtree_node_handle& operator=(const rbtree_node_handle&) = delete;
+
+        rbtree_node_handle(rbtree_node_handle&& other) noexcept
+            : node_allocator(other.get_allocator())
+            , m_node(other.release()) {}
+
+        rbtree_node_handle& operator=(rbtree_node_handle&& other) noexcept {
+            if (this != &other) {
+                reset();
+                static_cast<node_allocator&>(*this) = static_cast<node_allocator&>(other);
+                m_node                              = other.release();
+            }
+            return *this;
+        }
+
+        ~rbtree_node_handle() { reset(); }
+
+        allocator_type get_allocator() const { return node_allocator::get_allocator(); }
+
+        bool empty() const { return m_node == nullptr; }
+        explicit operator bool() const { return m_node != nullptr; }
+
+        /// @brief The value of a set node.
+        value_type& value() const { return m_node->data; }
+
+        /// @brief The key of a map node, it can be changed before the node is inserted again.
+        template <typename V = Value>
+        typename std::remove_const<typename V::first_type>::type& key() const {
+            return const_cast<typename std::remove_const<typename V::first_type>::type&>(m_node->data.first);
+        }
+
+        /// @brief The mapped value of a map node.
+        template <typename V = Value>
+        typename V::second_type& mapped() const { return m_node->data.second; }
+
+        friend void swap(rbtree_node_handle& lhs, rbtree_node_handle& rhs) noexcept {
+            TinySTL::swap(static_cast<node_allocator&>(lhs), static_cast<node_allocator&>(rhs));
+            TinySTL::swap(lhs.m_node, rhs.m_node);
+        }
+    };
+
     template <typename T, typename Alloc>
-    struct rbtree_base {
+    struct rbtree_base : protected simple_alloc<rbtree_node<T>, Alloc> {
         using allocator_type = Alloc;
 
-        rbtree_base(const allocator_type&) { m_sentinel = get_node(); }
+        rbtree_base(const allocator_type& allocator)
+            : rbtree_node_allocator(allocator) { m_sentinel = get_node(); }
         ~rbtree_base() { put_node(m_sentinel); }
 
+        allocator_type get_allocator() const { return rbtree_node_allocator::get_allocator(); }
+
     protected:
         typedef simple_alloc<rbtree_node<T>, Alloc> rbtree_node_allocator;
 
@@ -331,9 +563,12 @@ namespace TinySTL {
         using base = rbtree_base<Value, Alloc>;
 
     protected:
-        using base_ptr    = rbtree_node_base*;
-        using rbtree_node = rbtree_node<Value>;
-        using color_type  = rbtree_color_type;
+        using base_ptr   = rbtree_node_base*;
+        using color_type = rbtree_color_type;
+
+        using base::get_node;
+        using base::m_sentinel;
+        using base::put_node;
 
     public:
         using key_type        = Key;
@@ -344,8 +579,9 @@ namespace TinySTL {
         using const_reference = const value_type&;
         using size_type       = size_t;
         using difference_type = ptrdiff_t;
-        using link_type       = rbtree_node*;
+        using link_type       = rbtree_node<Value>*;
         using allocator_type  = typename base::allocator_type;
+        using node_type       = rbtree_node_handle<Value, Alloc>;
 
     protected:
         // Total number of nodes in the tree.
@@ -438,7 +674,7 @@ namespace TinySTL {
             }
             else {
                 s_color(m_sentinel) = rbtree_red;
-                root(m_sentinel)    = rbtree_copy(other.root(), m_sentinel);
+                root()              = rbtree_copy(other.root(), m_sentinel);
                 leftmost()          = s_minimum(root());
                 rightmost()         = s_maximum(root());
             }
@@ -456,8 +692,8 @@ namespace TinySTL {
                 }
                 else {
                     root()      = rbtree_copy(other.root(), m_sentinel);
-                    leftmost()  = minimum(root());
-                    rightmost() = minimum(root());
+                    leftmost()  = s_minimum(root());
+                    rightmost() = s_maximum(root());
                 }
             }
             return *this;
@@ -466,6 +702,8 @@ namespace TinySTL {
         ~rbtree() { clear(); }
 
     public:
+        using base::get_allocator;
+
         Compare key_comp() const { return m_key_compare; }
         iterator begin() { return iterator(leftmost()); }
         iterator end() { return m_sentinel; }
@@ -474,11 +712,15 @@ namespace TinySTL {
         bool empty() const { return m_node_count == 0; }
         size_type size() const { return m_node_count; }
 
+        void swap(rbtree& other) noexcept {
+            TinySTL::swap(static_cast<typename base::rbtree_node_allocator&>(*this), static_cast<typename base::rbtree_node_allocator&>(other));
+            TinySTL::swap(m_sentinel, other.m_sentinel);
+            TinySTL::swap(m_node_count, other.m_node_count);
+            TinySTL::swap(m_key_compare, other.m_key_compare);
+        }
+
         friend void swap(rbtree& lhs, rbtree& rhs) noexcept {
-            using TinySTL::swap;
-            swap(lhs.m_sentinel, rhs.m_sentinel);
-            swap(lhs.m_node_count, rhs.m_node_count);
-            swap(lhs.m_key_compare, rhs.m_key_compare);
+            lhs.swap(rhs);
         }
 
         friend bool operator==(const rbtree& lhs, const rbtree& rhs) noexcept {
@@ -541,7 +783,7 @@ namespace TinySTL {
                 }
             }
             catch (const std::exception&) {
-                rbtree_erase(top);
+                erase_aux(top);
                 throw;
             }
 
@@ -549,13 +791,17 @@ namespace TinySTL {
         }
 
         iterator insert_aux(base_ptr x, base_ptr y, const value_type& value) {
+            return insert_node_aux(x, y, create_node(value));
+        }
+
+        // Link the node `zz` as a child of `y`.
+        iterator insert_node_aux(base_ptr x, base_ptr y, link_type zz) {
             link_type xx = (link_type)x;
             // `yy` is the parent of `zz`.
             link_type yy = (link_type)y;
-            link_type zz = create_node(value);
 
             // Insert at the left.
-            if (yy == m_sentinel || xx != nullptr || m_key_compare(KeyOfValue()(value), s_key(yy))) {
+            if (yy == m_sentinel || xx != nullptr || m_key_compare(s_key(zz), s_key(yy))) {
                 s_left(yy) = zz;
                 // Tree was empty.
                 if (yy == m_sentinel) {
@@ -577,37 +823,85 @@ namespace TinySTL {
             s_left(zz)   = nullptr;
             s_right(zz)  = nullptr;
             s_parent(zz) = yy;
-            rbtree_rebalance_for_insert(zz, root());
+            rbtree_rebalance_for_insert(zz, m_sentinel->parent);
             ++m_node_count;
             return iterator(zz);
         }
 
-        void erase_aux(link_type x) {
+        // Destroy the subtree of `x` and push its nodes into `chain`.
+        void erase_aux(link_type x, __node_chain<rbtree_node<Value>>& chain) {
             while (x != nullptr) {
                 // Erase right subtree.
-                erase_aux(s_right(x));
+                erase_aux(s_right(x), chain);
                 // Switch to left subtree.
                 link_type y = s_left(x);
-                destroy_node(x);
+                destory(&x->data);
+                chain.push(x);
                 x = y;
             }
         }
 
-    public:
-        iterator insert_equal(const value_type& value) {
-            // Node being compared with `value`.
+        // Destroy the subtree of `x` and give its nodes back to the allocator at once.
+        void erase_aux(link_type x) {
+            __node_chain<rbtree_node<Value>> chain;
+            erase_aux(x, chain);
+            base::rbtree_node_allocator::deallocate_chain(chain);
+        }
+
+        // Find the parent of a new node of `key`, after the nodes of the equal keys.
+        link_type equal_position(const Key& key) {
             link_type x = root();
-            // `y` will be parent of node containing `value`.
             link_type y = m_sentinel;
+            while (x != nullptr) {
+                y = x;
+                x = m_key_compare(key, s_key(x)) ? s_left(x) : s_right(x);
+            }
+            return y;
+        }
+
+        // Find the parent `y` of a new node of `key`.
+        // If there is a node of the same key already, return false and the node as `equal`.
+        bool unique_position(const Key& key, link_type& y, iterator& equal) {
+            link_type x = root();
+            y           = m_sentinel;
             bool comp   = true;
 
             while (x != nullptr) {
                 y    = x;
-                comp = m_key_compare(KeyOfValue()(value), s_key(x));
+                comp = m_key_compare(key, s_key(x));
                 x    = comp ? s_left(x) : s_right(x);
             }
-            // `x` will always be `nullptr`.
-            return insert_aux(x, y, value);
+
+            // `y` will be the parent of the node of `key`.
+            // If `comp` is true, `key` is smaller than the key of `y`, so the new node is the left child of `y`.
+            iterator i = iterator(y);
+            if (comp) {
+                if (i == begin()) {
+                    // Insert at the left of the leftmost node.
+                    return true;
+                }
+                // The node before `y` is the largest with a key not greater than `key`.
+                --i;
+            }
+            // `key` is not smaller than the key of `i`, they are equal unless it is greater.
+            if (m_key_compare(s_key(i.m_node), key)) {
+                return true;
+            }
+            // A node of `key` exists, insert failed.
+            equal = i;
+            return false;
+        }
+
+        // Unlink the node of `pos` from the tree without destroying it.
+        link_type unlink_node(iterator pos) {
+            link_type y = static_cast<link_type>(rbtree_rebalance_for_erase(pos.m_node, m_sentinel->parent, m_sentinel->left, m_sentinel->right));
+            --m_node_count;
+            return y;
+        }
+
+    public:
+        iterator insert_equal(const value_type& value) {
+            return insert_aux(nullptr, equal_position(KeyOfValue()(value)), value);
         }
 
         iterator insert_equal(iterator pos, const value_type& value) {
@@ -661,39 +955,12 @@ namespace TinySTL {
         }
 
         TinySTL::pair<iterator, bool> insert_unique(const value_type& value) {
-            link_type x = root();
-            link_type y = m_sentinel;
-            bool comp   = true;
-
-            while (x != nullptr) {
-                y    = x;
-                comp = m_key_compare(KeyOfValue()(value), s_key(x));
-                x    = comp ? s_left(x) : s_right(x);
-            }
-
-            // `i` will be parent of node containing `value`.
-            // If there are multiple nodes containing `i`'value, `i` will be the right most one.
-            iterator i = iterator(y);
-            // If `comp` is true, which means `value` is smaller than `i`'s value,
-            // then new node is a left child of `i`.
-            if (comp) {
-                if (i == begin()) {
-                    // Insert at the left of the leftmost node.
-                    // `x` will always be `nullptr`.
-                    return TinySTL::pair<iterator, bool>(insert_aux(x, y, value), true);
-                }
-                else {
-                    // Find a smaller node than `i`, which may be equal to the given value.
-                    --i;
-                }
-            }
-            // Equal check.
-            if (m_key_compare(s_key(i.m_node), KeyOfValue()(value))) {
-                // `x` will always be `nullptr`.
-                return TinySTL::pair<iterator, bool>(insert_aux(x, y, value), true);
+            link_type y;
+            iterator equal;
+            if (!unique_position(KeyOfValue()(value), y, equal)) {
+                return TinySTL::pair<iterator, bool>(equal, false);
             }
-            // If equal, insert failed.
-            return TinySTL::pair<iterator, bool>(i, false);
+            return TinySTL::pair<iterator, bool>(insert_aux(nullptr, y, value), true);
         }
 
         iterator insert_unique(iterator pos, const value_type& value) {
@@ -747,14 +1014,12 @@ namespace TinySTL {
         }
 
         void erase(iterator pos) {
-            link_type y = static_cast<link_type>(rbtree_rebalance_for_erase(pos.m_node, root(), leftmost(), rightmost()));
-            destroy_node(y);
-            --m_node_count;
+            destroy_node(unlink_node(pos));
         }
 
         size_type erase(const Key& key) {
-            std::pair<iterator, iterator> p = equal_range(key);
-            size_type n                     = TinySTL::distance(p.first, p.second);
+            TinySTL::pair<iterator, iterator> p = equal_range(key);
+            size_type n                         = TinySTL::distance(p.first, p.second);
             erase(p.first, p.second);
             return n;
         }
@@ -765,17 +1030,84 @@ namespace TinySTL {
             }
         }
 
-        void erase(const_iterator first, const_iterator last) {
+        void erase(iterator first, iterator last) {
             if (first == begin() && last == end()) {
                 clear();
             }
             else {
-                for (; first != last; ++first) {
-                    erase(first);
+                while (first != last) {
+                    erase(first++);
                 }
             }
         }
 
+        /// @brief Unlink the node of `pos` and hand it over, nothing is destroyed or freed.
+        node_type extract(iterator pos) {
+            return node_type(unlink_node(pos), get_allocator());
+        }
+
+        /// @brief Extract the first node of `key`, or return an empty handle.
+        node_type extract(const Key& key) {
+            iterator i = find(key);
+            return i == end() ? node_type() : extract(i);
+        }
+
+        /// @brief Link the node of `node` if its key is not in the tree yet, otherwise the node stays in `node`.
+        TinySTL::pair<iterator, bool> insert_unique(node_type&& node) {
+            if (node.empty()) {
+                return TinySTL::pair<iterator, bool>(end(), false);
+            }
+            link_type y;
+            iterator equal;
+            if (!unique_position(s_key(node.m_node), y, equal)) {
+                return TinySTL::pair<iterator, bool>(equal, false);
+            }
+            return TinySTL::pair<iterator, bool>(insert_node_aux(nullptr, y, node.release()), true);
+        }
+
+        /// @brief Link the node of `node` after the nodes of the equal keys.
+        iterator insert_equal(node_type&& node) {
+            if (node.empty()) {
+                return end();
+            }
+            link_type y = equal_position(s_key(node.m_node));
+            return insert_node_aux(nullptr, y, node.release());
+        }
+
+        /// @brief Move the nodes of `other` whose keys are not in this tree yet, by relinking them.
+        /// The nodes are not copied or allocated, the trees should have allocators that can free each other's nodes.
+        void merge_unique(rbtree& other) {
+            if (this == &other) {
+                return;
+            }
+            iterator first = other.begin();
+            while (first != other.end()) {
+                iterator next = first;
+                ++next;
+                link_type y;
+                iterator equal;
+                if (unique_position(s_key(first.m_node), y, equal)) {
+                    insert_node_aux(nullptr, y, other.unlink_node(first));
+                }
+                first = next;
+            }
+        }
+
+        /// @brief Move all the nodes of `other` by relinking them.
+        void merge_equal(rbtree& other) {
+            if (this == &other) {
+                return;
+            }
+            iterator first = other.begin();
+            while (first != other.end()) {
+                iterator next = first;
+                ++next;
+                link_type z = other.unlink_node(first);
+                insert_node_aux(nullptr, equal_position(s_key(z)), z);
+                first = next;
+            }
+        }
+
         void clear() {
             if (m_node_count != 0) {
                 erase_aux(root());
@@ -1,6 +1,8 @@
 #ifndef _TINYSTL_TYPE_TRAITS_HPP_
 #define _TINYSTL_TYPE_TRAITS_HPP_
 
+#include <type_traits>
+
 namespace TinySTL {
 
     struct __true_type {};
@@ -181,6 +183,20 @@ namespace TinySTL {
         using is_POD_type                     = __true_type;
     };
 
+    // Whether `T` is an integer, used to tell `(n, value)` from an iterator range `(first, last)`.
+    template <typename T>
+    struct __is_integer {
+        using integral = typename std::conditional<std::is_integral<T>::value, __true_type, __false_type>::type;
+    };
+
+    // Whether an object can be moved to another address by copying its bytes and forgetting the old ones,
+    // so a buffer of them can be grown by `realloc`.
+    // It is true for the trivially copyable types, specialize it for the other relocatable types.
+    template <typename T>
+    struct __is_trivially_relocatable {
+        static constexpr bool value = std::is_trivially_copyable<T>::value;
+    };
+
 }; // namespace TinySTL
 
 #endif // !_TINYSTL_TYPE_TRAITS_HPP_
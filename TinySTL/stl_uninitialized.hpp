@@ -39,6 +39,39 @@ namespace TinySTL {
 
     //! uninitialized_copy.
 
+    //! uninitialized_move_if_noexcept.
+
+    /// @brief If the type is POD type, copy the data is enough.
+    template <typename InputIterator, typename ForwardIterator>
+    ForwardIterator _uninitialized_move_if_noexcept_aux(InputIterator first, InputIterator last, ForwardIterator result, __true_type) {
+        return copy(first, last, result);
+    }
+
+    /// @brief If the type is not POD type, move construct one by one if the move does not throw, otherwise copy construct.
+    template <typename InputIterator, typename ForwardIterator>
+    ForwardIterator _uninitialized_move_if_noexcept_aux(InputIterator first, InputIterator last, ForwardIterator result, __false_type) {
+        for (; first != last; ++first, ++result) {
+            construct(&*result, std::move_if_noexcept(*first));
+        }
+        return result;
+    }
+
+    /// @brief Dispatch to auxilary function that based on whether it is POD type or not.
+    template <typename InputIterator, typename ForwardIterator, typename T>
+    ForwardIterator _uninitialized_move_if_noexcept(InputIterator first, InputIterator last, ForwardIterator result, T*) {
+        using is_POD = typename __type_traits<T>::is_POD_type;
+        return _uninitialized_move_if_noexcept_aux(first, last, result, is_POD());
+    }
+
+    /// @brief Move the elements to uninitialized space, used when a container reallocates.
+    /// The elements are copied instead if their move constructor may throw, so the old elements survive a failure.
+    template <typename InputIterator, typename ForwardIterator>
+    ForwardIterator uninitialized_move_if_noexcept(InputIterator first, InputIterator last, ForwardIterator result) {
+        return _uninitialized_move_if_noexcept(first, last, result, value_type(result));
+    }
+
+    //! uninitialized_move_if_noexcept.
+
     //! uninitialized_fill.
 
     /// @brief If the type is POD type, copy the data is enough.
@@ -101,6 +134,41 @@ namespace TinySTL {
 
     //! uninitialized_fill_n.
 
+    //! uninitialized_default_n.
+
+    /// @brief If the type has trivial default constructor, leave the memory as it is.
+    template <typename ForwardIterator, typename size>
+    ForwardIterator _uninitialized_default_n_aux(ForwardIterator first, size n, __true_type) {
+        TinySTL::advance(first, n);
+        return first;
+    }
+
+    /// @brief If the type does not have trivial default constructor, construct one by one.
+    /// `new T` rather than `construct`, which is `new T()` and would zero a struct with no constructor.
+    template <typename ForwardIterator, typename size>
+    ForwardIterator _uninitialized_default_n_aux(ForwardIterator first, size n, __false_type) {
+        using T = typename iterator_traits<ForwardIterator>::value_type;
+        for (; n > 0; --n, ++first)
+            ::new (static_cast<void*>(&*first)) T;
+        return first;
+    }
+
+    /// @brief Dispatch to auxilary function that based on whether the default constructor is trivial or not.
+    template <typename ForwardIterator, typename size, typename I>
+    ForwardIterator _uninitialized_default_n(ForwardIterator first, size n, I*) {
+        // `__type_traits` says false for every class, so ask the compiler.
+        using trivial = typename std::conditional<std::is_trivially_default_constructible<I>::value, __true_type, __false_type>::type;
+        return _uninitialized_default_n_aux(first, n, trivial());
+    }
+
+    /// @brief Default initialize n objects, the memory of trivial types is not touched.
+    template <typename ForwardIterator, typename size>
+    ForwardIterator uninitialized_default_n(ForwardIterator first, size n) {
+        return _uninitialized_default_n(first, n, value_type(first));
+    }
+
+    //! uninitialized_default_n.
+
 } // namespace TinySTL
 
 #endif // !_TINYSTL_UNINITIALIZED_HPP_
@@ -0,0 +1,486 @@
+#ifndef _TINYSTL_UNROLLED_LIST_HPP_
+#define _TINYSTL_UNROLLED_LIST_HPP_
+
+#include <cstdint>
+#include <utility>
+#include <stl_algorithm.hpp>
+#include <stl_allocator.hpp>
+#include <stl_iterator.hpp>
+#include <stl_type_traits.hpp>
+#include <stl_uninitialized.hpp>
+
+namespace TinySTL {
+
+    // Number of elements in a node, `n` if given, otherwise as many as fit in 256 bytes.
+    constexpr size_t __unrolled_list_node_capacity(size_t n, size_t size) {
+        return n != 0 ? n : (size < 256 ? 256 / size : 1);
+    }
+
+    // A node holds up to `N` elements in its buffer, the first `count` of them are constructed.
+    template <typename T, size_t N>
+    struct unrolled_list_node {
+        unrolled_list_node* prev;
+        unrolled_list_node* next;
+        size_t count;
+        alignas(T) unsigned char buffer[N * sizeof(T)];
+
+        T* data() { return reinterpret_cast<T*>(buffer); }
+    };
+
+    template <typename T, typename Ref, typename Ptr, size_t N>
+    struct unrolled_list_iterator {
+        using iterator       = unrolled_list_iterator<T, T&, T*, N>;
+        using const_iterator = unrolled_list_iterator<T, const T&, const T*, N>;
+        using self           = unrolled_list_iterator<T, Ref, Ptr, N>;
+
+        using iterator_category = bidirectional_iterator_tag;
+        using value_type        = T;
+        using pointer           = Ptr;
+        using reference         = Ref;
+        using size_type         = size_t;
+        using difference_type   = ptrdiff_t;
+
+        using node = unrolled_list_node<T, N>;
+
+        // Iterator over the nodes, for the segmented algorithms.
+        struct segment_iterator {
+            node* m_node;
+
+            segment_iterator(node* n = nullptr)
+                : m_node(n) {}
+
+            friend bool operator==(const segment_iterator& lhs, const segment_iterator& rhs) noexcept { return lhs.m_node == rhs.m_node; }
+            friend bool operator!=(const segment_iterator& lhs, const segment_iterator& rhs) noexcept { return !(lhs == rhs); }
+
+            segment_iterator& operator++() {
+                m_node = m_node->next;
+                return *this;
+            }
+        };
+
+    public:
+        // The end iterator is at the first slot of the sentinel node.
+        node* m_node;
+        T* m_curr;
+
+        unrolled_list_iterator()
+            : m_node(nullptr)
+            , m_curr(nullptr) {}
+        unrolled_list_iterator(node* n, T* curr)
+            : m_node(n)
+            , m_curr(curr) {}
+        unrolled_list_iterator(const iterator& other)
+            : m_node(other.m_node)
+            , m_curr(other.m_curr) {}
+
+        friend bool operator==(const self& lhs, const self& rhs) noexcept { return lhs.m_curr == rhs.m_curr; }
+        friend bool operator!=(const self& lhs, const self& rhs) noexcept { return !(lhs == rhs); }
+
+        reference operator*() const { return *m_curr; }
+        pointer operator->() const { return m_curr; }
+
+        self& operator++() {
+            if (++m_curr == m_node->data() + m_node->count) {
+                m_node = m_node->next;
+                m_curr = m_node->data();
+            }
+            return *this;
+        }
+        self operator++(int) {
+            self temp = *this;
+            ++*this;
+            return temp;
+        }
+        self& operator--() {
+            if (m_curr == m_node->data()) {
+                m_node = m_node->prev;
+                m_curr = m_node->data() + m_node->count;
+            }
+            --m_curr;
+            return *this;
+        }
+        self operator--(int) {
+            self temp = *this;
+            --*this;
+            return temp;
+        }
+    };
+
+    template <typename T, typename Ref, typename Ptr, size_t N>
+    struct __segmented_iterator_traits<unrolled_list_iterator<T, Ref, Ptr, N>> {
+        using is_segmented     = __true_type;
+        using iterator         = unrolled_list_iterator<T, Ref, Ptr, N>;
+        using segment_iterator = typename iterator::segment_iterator;
+        using local_iterator   = Ptr;
+
+        static segment_iterator segment(const iterator& it) { return it.m_node; }
+        static local_iterator local(const iterator& it) { return it.m_curr; }
+        static local_iterator begin(segment_iterator segment) { return segment.m_node->data(); }
+        static local_iterator end(segment_iterator segment) { return segment.m_node->data() + segment.m_node->count; }
+
+        // `local` may be the end of a node, which is the begin of the next one.
+        static iterator compose(segment_iterator segment, local_iterator local) {
+            if (local == end(segment) && local != begin(segment)) {
+                ++segment;
+                return iterator(segment.m_node, segment.m_node->data());
+            }
+            return iterator(segment.m_node, const_cast<T*>(local));
+        }
+    };
+
+    // Doubly linked list of nodes that hold several elements each, iterated like `list` with one cache miss per node.
+    // Inserting into a full node splits it in halves, erasing merges a node with the next one when they fit in `_FILL_THRESHOLD` elements.
+    // Inserting or erasing moves the elements of the same node, so it invalidates the iterators into that node (and into the node it
+    // is split into or merged with). The iterators into the other nodes stay valid.
+    template <typename T, typename Alloc = alloc, size_t NodeCapacity = 0>
+    class unrolled_list : private simple_alloc<unrolled_list_node<T, __unrolled_list_node_capacity(NodeCapacity, sizeof(T))>, Alloc> {
+    private:
+        enum : size_t { _NODE_CAPACITY = __unrolled_list_node_capacity(NodeCapacity, sizeof(T)) };
+        // Two neighbour nodes are merged when they hold at most this many elements together,
+        // so a merged node still has room for some inserts before it splits again.
+        enum : size_t { _FILL_THRESHOLD = _NODE_CAPACITY - _NODE_CAPACITY / 4 };
+
+    public:
+        using value_type      = T;
+        using pointer         = T*;
+        using reference       = T&;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using const_pointer   = const T*;
+        using const_reference = const T&;
+        using node            = unrolled_list_node<T, _NODE_CAPACITY>;
+
+        using node_allocator = simple_alloc<node, Alloc>;
+        using allocator_type = Alloc;
+
+        using iterator       = unrolled_list_iterator<T, T&, T*, _NODE_CAPACITY>;
+        using const_iterator = unrolled_list_iterator<T, const T&, const T*, _NODE_CAPACITY>;
+
+    protected:
+        // The sentinel is a node without elements, like the one of `list`.
+        node* m_sentinel;
+        size_type m_size;
+
+    private:
+        // The allocators promise blocks aligned to 8 bytes, the `_ALIGN` of the pool, more only from `malloc`.
+        // A node of an over-aligned type is cut out of a larger block,
+        // and the distance back to the block is kept in the word before the node.
+        enum : size_t { _ALLOC_ALIGN = 8 };
+        enum : size_t { _ALIGNED_BLOCK = sizeof(node) + alignof(node) };
+
+        using over_aligned   = typename std::conditional<(alignof(node) > _ALLOC_ALIGN), __true_type, __false_type>::type;
+        using byte_allocator = simple_alloc<unsigned char, Alloc>;
+
+        node* get_node() { return get_node_aux(over_aligned()); }
+        void put_node(node* n) { put_node_aux(n, over_aligned()); }
+
+        node* get_node_aux(__false_type) { return node_allocator::allocate((size_type)1); }
+        void put_node_aux(node* n, __false_type) { node_allocator::deallocate(n); }
+
+        node* get_node_aux(__true_type) {
+            unsigned char* block = byte_allocator(get_allocator()).allocate(_ALIGNED_BLOCK);
+            // `block` is aligned to `_ALLOC_ALIGN`, so there are at least `_ALLOC_ALIGN` bytes before the node.
+            unsigned char* aligned                 = block + (alignof(node) - reinterpret_cast<std::uintptr_t>(block) % alignof(node));
+            reinterpret_cast<size_t*>(aligned)[-1] = (size_t)(aligned - block);
+            return reinterpret_cast<node*>(aligned);
+        }
+
+        void put_node_aux(node* n, __true_type) {
+            unsigned char* aligned = reinterpret_cast<unsigned char*>(n);
+            byte_allocator(get_allocator()).deallocate(aligned - reinterpret_cast<size_t*>(aligned)[-1], _ALIGNED_BLOCK);
+        }
+
+        /// @brief: Give a chain of nodes back at once.
+        void put_chain(const __node_chain<node>& chain, __false_type) { node_allocator::deallocate_chain(chain); }
+
+        /// @brief: Over-aligned nodes are not blocks of the allocator, give them back one by one.
+        void put_chain(const __node_chain<node>& chain, __true_type) {
+            node* curr = chain.head;
+            for (size_t i = 0; i < chain.count; ++i) {
+                node* next = *reinterpret_cast<node**>(curr);
+                put_node(curr);
+                curr = next;
+            }
+        }
+
+        void init() {
+            m_sentinel        = get_node();
+            m_sentinel->next  = m_sentinel;
+            m_sentinel->prev  = m_sentinel;
+            m_sentinel->count = 0;
+            m_size            = 0;
+        }
+
+        /// @brief: Link a new empty node after `pos`.
+        node* create_node_after(node* pos) {
+            node* n         = get_node();
+            n->count        = 0;
+            n->prev         = pos;
+            n->next         = pos->next;
+            pos->next->prev = n;
+            pos->next       = n;
+            return n;
+        }
+
+        /// @brief: Unlink the empty node `n` and free it.
+        void remove_node(node* n) {
+            n->prev->next = n->next;
+            n->next->prev = n->prev;
+            put_node(n);
+        }
+
+        /// @brief: Insert `value` at `idx` of `n`, which is not full, moving the later elements one slot back.
+        void insert_in_node(node* n, size_type idx, const T& value) {
+            T* first = n->data() + idx;
+            T* last  = n->data() + n->count;
+            if (first == last) {
+                construct(last, value);
+            }
+            else {
+                // Copy `value` first, since it may be an element of this node.
+                T temp(value);
+                construct(last, std::move(*(last - 1)));
+                TinySTL::move_backward(first, last - 1, last);
+                *first = std::move(temp);
+            }
+            ++n->count;
+        }
+
+        /// @brief: Move the later half of the full node `n` to a new node after it.
+        void split_node(node* n) {
+            node* m             = create_node_after(n);
+            const size_type mid = n->count / 2;
+            try {
+                TinySTL::uninitialized_move_if_noexcept(n->data() + mid, n->data() + n->count, m->data());
+            }
+            catch (const std::exception&) {
+                remove_node(m);
+                throw;
+            }
+            destory(n->data() + mid, n->data() + n->count);
+            m->count = n->count - mid;
+            n->count = mid;
+        }
+
+        /// @brief: Move the elements of `n->next` to the end of `n` and free the next node, if they fit in the fill threshold.
+        void merge_next(node* n) {
+            node* next = n->next;
+            if (next == m_sentinel || n->count + next->count > _FILL_THRESHOLD) {
+                return;
+            }
+            TinySTL::uninitialized_move_if_noexcept(next->data(), next->data() + next->count, n->data() + n->count);
+            destory(next->data(), next->data() + next->count);
+            n->count += next->count;
+            remove_node(next);
+        }
+
+        /// @brief: Destroy the elements and give all the nodes but the sentinel back to the allocator at once.
+        void destory_nodes() {
+            __node_chain<node> chain;
+            node* curr = m_sentinel->next;
+            while (curr != m_sentinel) {
+                node* temp = curr;
+                curr       = curr->next;
+                destory(temp->data(), temp->data() + temp->count);
+                chain.push(temp);
+            }
+            put_chain(chain, over_aligned());
+        }
+
+    public:
+        unrolled_list() { init(); }
+
+        explicit unrolled_list(const Alloc& a)
+            : node_allocator(a) {
+            init();
+        }
+
+        explicit unrolled_list(size_type n, const T& value = value_type(), const Alloc& a = Alloc())
+            : node_allocator(a) {
+            init();
+            try {
+                for (; n > 0; --n) {
+                    push_back(value);
+                }
+            }
+            catch (const std::exception&) {
+                clear();
+                put_node(m_sentinel);
+                throw;
+            }
+        }
+
+        unrolled_list(const unrolled_list& other)
+            : node_allocator(other.get_allocator()) {
+            init();
+            try {
+                append(other.begin(), other.end());
+            }
+            catch (const std::exception&) {
+                clear();
+                put_node(m_sentinel);
+                throw;
+            }
+        }
+
+        unrolled_list& operator=(const unrolled_list& other) {
+            if (this != &other) {
+                clear();
+                append(other.begin(), other.end());
+            }
+            return *this;
+        }
+
+        ~unrolled_list() {
+            destory_nodes();
+            put_node(m_sentinel);
+        }
+
+        allocator_type get_allocator() const { return node_allocator::get_allocator(); }
+
+        iterator begin() { return iterator(m_sentinel->next, m_sentinel->next->data()); }
+        iterator end() { return iterator(m_sentinel, m_sentinel->data()); }
+        const_iterator begin() const { return const_iterator(m_sentinel->next, m_sentinel->next->data()); }
+        const_iterator end() const { return const_iterator(m_sentinel, m_sentinel->data()); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        size_type size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        static constexpr size_type node_capacity() { return _NODE_CAPACITY; }
+
+        reference front() { return *begin(); }
+        reference back() { return *(--end()); }
+        const_reference front() const { return *begin(); }
+        const_reference back() const { return *(--end()); }
+
+        friend bool operator==(const unrolled_list& lhs, const unrolled_list& rhs) {
+            return lhs.size() == rhs.size() && TinySTL::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator!=(const unrolled_list& lhs, const unrolled_list& rhs) {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const unrolled_list& lhs, const unrolled_list& rhs) {
+            return TinySTL::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+        friend bool operator>(const unrolled_list& lhs, const unrolled_list& rhs) {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const unrolled_list& lhs, const unrolled_list& rhs) {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const unrolled_list& lhs, const unrolled_list& rhs) {
+            return !(lhs < rhs);
+        }
+
+        void push_back(const T& value) {
+            node* last = m_sentinel->prev;
+            if (last == m_sentinel || last->count == _NODE_CAPACITY) {
+                last = create_node_after(last);
+            }
+            try {
+                construct(last->data() + last->count, value);
+            }
+            catch (const std::exception&) {
+                if (last->count == 0) {
+                    remove_node(last);
+                }
+                throw;
+            }
+            ++last->count;
+            ++m_size;
+        }
+
+        void push_front(const T& value) { insert(begin(), value); }
+
+        /// @brief Append [`first`, `last`), filling the last node before linking new ones.
+        template <typename InputIterator>
+        void append(InputIterator first, InputIterator last) {
+            for (; first != last; ++first) {
+                push_back(*first);
+            }
+        }
+
+        iterator insert(iterator pos, const T& value) {
+            node* n       = pos.m_node;
+            size_type idx = pos.m_curr - n->data();
+            if (n == m_sentinel) {
+                push_back(value);
+                return --end();
+            }
+            // At the begin of a node, prefer the room at the end of the previous node, nothing has to be moved.
+            if (idx == 0 && n->prev != m_sentinel && n->prev->count < _NODE_CAPACITY) {
+                n   = n->prev;
+                idx = n->count;
+            }
+            else if (n->count == _NODE_CAPACITY) {
+                split_node(n);
+                if (idx > n->count) {
+                    idx -= n->count;
+                    n = n->next;
+                }
+            }
+            insert_in_node(n, idx, value);
+            ++m_size;
+            return iterator(n, n->data() + idx);
+        }
+
+        void insert(iterator pos, size_type n, const T& value) {
+            for (; n > 0; --n) {
+                pos = insert(pos, value);
+            }
+        }
+
+        iterator erase(iterator pos) {
+            node* n       = pos.m_node;
+            size_type idx = pos.m_curr - n->data();
+            T* last       = n->data() + n->count;
+            TinySTL::move(pos.m_curr + 1, last, pos.m_curr);
+            destory(last - 1);
+            --n->count;
+            --m_size;
+            if (n->count == 0) {
+                node* next = n->next;
+                remove_node(n);
+                return iterator(next, next->data());
+            }
+            merge_next(n);
+            if (idx == n->count) {
+                return iterator(n->next, n->next->data());
+            }
+            return iterator(n, n->data() + idx);
+        }
+
+        iterator erase(iterator first, iterator last) {
+            // `last` may be moved by the erasing, so count the elements first.
+            for (size_type n = (size_type)TinySTL::distance(first, last); n > 0; --n) {
+                first = erase(first);
+            }
+            return first;
+        }
+
+        void pop_front() { erase(begin()); }
+        void pop_back() { erase(--end()); }
+
+        void clear() {
+            destory_nodes();
+            m_sentinel->next = m_sentinel;
+            m_sentinel->prev = m_sentinel;
+            m_size           = 0;
+        }
+
+        friend void swap(unrolled_list& lhs, unrolled_list& rhs) noexcept {
+            TinySTL::swap(static_cast<node_allocator&>(lhs), static_cast<node_allocator&>(rhs));
+            TinySTL::swap(lhs.m_sentinel, rhs.m_sentinel);
+            TinySTL::swap(lhs.m_size, rhs.m_size);
+        }
+    };
+
+} // namespace TinySTL
+
+#endif // !_TINYSTL_UNROLLED_LIST_HPP_
@@ -1,6 +1,7 @@
 #ifndef _TINYSTL_VECTOR_HPP_
 #define _TINYSTL_VECTOR_HPP_
 
+#include <utility>
 #include <stl_algorithm.hpp>
 #include <stl_allocator.hpp>
 #include <stl_iterator.hpp>
@@ -9,8 +10,32 @@
 
 namespace TinySTL {
 
-    template <typename T, typename Alloc = allocator<T>>
-    class vector {
+    // Growth policies decide the capacity of a full vector.
+    // A growth policy provides:
+    // `next(capacity, required)`: the new capacity, no less than `required`.
+
+    // Multiply the capacity by `Num / Den`.
+    // 2 doubles it, 1.5 lets a freed buffer be reused by a later growth.
+    template <size_t Num = 2, size_t Den = 1>
+    struct __geometric_growth_policy {
+        static_assert(Num > Den, "The growth factor should be larger than 1.");
+
+        static size_t next(size_t capacity, size_t required) {
+            size_t grown = capacity + capacity * (Num - Den) / Den;
+            if (grown < required) {
+                grown = required;
+            }
+            return grown != 0 ? grown : 1;
+        }
+    };
+
+    // Tag of the constructors that default initialize the elements,
+    // the elements of trivial types are left uninitialized.
+    struct default_init_t {};
+    constexpr default_init_t default_init = default_init_t();
+
+    template <typename T, typename Alloc = alloc, typename GrowthPolicy = __geometric_growth_policy<>>
+    class vector : private simple_alloc<T, Alloc> {
     public:
         using value_type       = T;
         using pointer          = T*;
@@ -22,6 +47,7 @@ namespace TinySTL {
         using const_iterator   = const T*;
         using const_reference  = const T&;
         using vector_allocator = simple_alloc<T, Alloc>;
+        using allocator_type   = Alloc;
 
     protected:
         // m_start position of used
@@ -32,38 +58,69 @@ namespace TinySTL {
         iterator m_end_of_storage;
 
     protected:
-        /// @brief: Insert one `value` at given `pos`.
-        void insert_aux(iterator pos, const T& value) {
+        /// @brief: Capacity after growing to hold `n` more elements.
+        size_type grown_capacity(size_type n) const {
+            return GrowthPolicy::next(capacity(), size() + n);
+        }
+
+        /// @brief: Grow the buffer to `new_capacity` by `Alloc::reallocate`, which may extend it in place.
+        /// Only for trivially relocatable elements.
+        void reallocate_storage(size_type new_capacity) {
+            const size_type old_size = size();
+            m_start                  = vector_allocator::reallocate(m_start, capacity(), new_capacity);
+            m_finish                 = m_start + old_size;
+            m_end_of_storage         = m_start + new_capacity;
+        }
+
+        /// @brief: Construct one value from `args` at given `pos`.
+        template <typename... Args>
+        void insert_aux(iterator pos, Args&&... args) {
             // If there are some space left.
             if (m_finish != m_end_of_storage) {
-                // Copy the value in `m_finish - 1` to `m_finish`, it need to be constructed first.
-                construct(m_finish, *(m_finish - 1));
+                // Construct the value first, since `args` may refer to an element of this vector.
+                T value(std::forward<Args>(args)...);
+                // Move the value in `m_finish - 1` to `m_finish`, it need to be constructed first.
+                construct(m_finish, std::move(*(m_finish - 1)));
                 // Increment.
                 ++m_finish;
-                // Copy the value in [`pos`, `m_finish - 1`) to [`pos + 1`, `m_finish`).
-                copy_backward(pos, m_finish - 2, m_finish - 1);
+                // Move the value in [`pos`, `m_finish - 2`) to [`pos + 1`, `m_finish - 1`).
+                TinySTL::move_backward(pos, m_finish - 2, m_finish - 1);
                 // Put the inserted value.
-                *pos = value;
+                *pos = std::move(value);
+            }
+            // If there is no space left, and the elements can be relocated by `Alloc::reallocate`.
+            else if (__is_trivially_relocatable<T>::value) {
+                // Construct the value first, since `args` may refer to an element of this vector.
+                T value(std::forward<Args>(args)...);
+                const size_type offset = pos - m_start;
+                reallocate_storage(grown_capacity(1));
+                emplace(m_start + offset, std::move(value));
             }
             // If there is no space left.
             else {
                 // Allocate new space.
                 const size_type old_capacity = capacity();
-                const size_type new_capacity = old_capacity != 0 ? 2 * old_capacity : 1;
+                const size_type new_capacity = grown_capacity(1);
                 iterator new_start           = vector_allocator::allocate(new_capacity);
+                iterator new_pos             = new_start + (pos - m_start);
                 iterator new_finish          = new_start;
+                // Put the inserted value first, since `args` may refer to an element of this vector.
                 try {
-                    // Copy old [`m_start`, `pos`) to [`new_start`, `pos`).
-                    new_finish = TinySTL::uninitialized_copy(m_start, pos, new_start);
-                    // Put the inserted value.
-                    construct(new_finish, value);
-                    // Increment.
-                    ++new_finish;
-                    // copy old [`pos`, `m_finish`) to new space starting from `pos + 1`, a.k.a `new_finish`.
-                    new_finish = TinySTL::uninitialized_copy(pos, m_finish, new_finish);
+                    construct(new_pos, std::forward<Args>(args)...);
+                }
+                catch (const std::exception&) {
+                    vector_allocator::deallocate(new_start, new_capacity);
+                    throw;
+                }
+                try {
+                    // Move old [`m_start`, `pos`) to [`new_start`, `new_pos`).
+                    new_finish = TinySTL::uninitialized_move_if_noexcept(m_start, pos, new_start);
+                    // Move old [`pos`, `m_finish`) to new space starting from `new_pos + 1`.
+                    new_finish = TinySTL::uninitialized_move_if_noexcept(pos, m_finish, new_pos + 1);
                 }
                 catch (const std::exception&) {
                     // If fail to construct, destroy and deallocate.
+                    destory(new_pos);
                     destory(new_start, new_finish);
                     vector_allocator::deallocate(new_start, new_capacity);
                     throw;
@@ -78,49 +135,156 @@ namespace TinySTL {
             }
         }
 
-        /// @brief: Insert one default value at given `pos`.
-        void insert_aux(iterator pos) {
-            // If there are some space left.
-            if (m_finish != m_end_of_storage) {
-                // Copy the value in `m_finish - 1` to `m_finish`, it need to be constructed first.
-                construct(m_finish, *(m_finish - 1));
-                // Increment.
-                ++m_finish;
-                // Copy the value in [`pos`, `m_finish - 1`) to [`pos + 1`, `m_finish`).
-                copy_backward(pos, m_finish - 2, m_finish - 1);
-                // Put the inserted value.
-                *pos = value_type();
+        template <typename Integer>
+        void insert_dispatch(iterator pos, Integer n, Integer value, __true_type) {
+            insert(pos, (size_type)n, (T)value);
+        }
+
+        template <typename InputIterator>
+        void insert_dispatch(iterator pos, InputIterator first, InputIterator last, __false_type) {
+            range_insert(pos, first, last, iterator_category(first));
+        }
+
+        /// @brief Insert an input range, whose length is unknown, so the space grows as the elements come.
+        template <typename InputIterator>
+        void range_insert(iterator pos, InputIterator first, InputIterator last, input_iterator_tag) {
+            // Append at the end.
+            if (pos == end()) {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
             }
-            // If there is no space left.
+            // Collect the elements first, then insert them as a forward range.
             else {
-                // Allocate new space.
-                const size_type old_capacity = capacity();
-                const size_type new_capacity = old_capacity != 0 ? 2 * old_capacity : 1;
-                iterator new_start           = vector_allocator::allocate(new_capacity);
-                iterator new_finish          = new_start;
+                vector temp(get_allocator());
+                temp.range_insert(temp.end(), first, last, input_iterator_tag());
+                range_insert(pos, temp.begin(), temp.end(), forward_iterator_tag());
+            }
+        }
+
+        /// @brief Insert a forward range, the space is allocated once for all the `distance(first, last)` elements.
+        template <typename ForwardIterator>
+        void range_insert(iterator pos, ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+            size_type n = TinySTL::distance(first, last);
+            // Grow the buffer of relocatable elements by `Alloc::reallocate`, then insert in place.
+            if (__is_trivially_relocatable<T>::value && (size_type)(m_end_of_storage - m_finish) < n) {
+                const size_type offset = pos - m_start;
+                reallocate_storage(grown_capacity(n));
+                pos = m_start + offset;
+            }
+            if (n != 0) {
+                // If there is enough space.
+                if ((size_type)(m_end_of_storage - m_finish) >= n) {
+                    const size_type n_elems_after = m_finish - pos;
+                    iterator old_finish           = m_finish;
+                    // If there are more elements after `pos` than number of inserted values.
+                    if (n_elems_after > n) {
+                        // Move [`m_finish - n`, `m_finish`) to [`m_finish`, `m_finish + n`).
+                        m_finish = TinySTL::uninitialized_move_if_noexcept(m_finish - n, m_finish, m_finish);
+                        // Move [`pos`, `m_finish - n`) to [`pos + n`, `m_finish`).
+                        TinySTL::move_backward(pos, old_finish - n, old_finish);
+                        // Copy [`first`, `last`) to [`pos`, `pos + n`).
+                        TinySTL::copy(first, last, pos);
+                    }
+                    // Otherwise, more inserted values.
+                    else {
+                        ForwardIterator mid = first;
+                        TinySTL::advance(mid, n_elems_after);
+                        // Copy [`mid`, `last`) to [`m_finish`, `pos + n`).
+                        m_finish = TinySTL::uninitialized_copy(mid, last, m_finish);
+                        // Move [`pos`, `m_finish`) to [`pos + n`, `m_finish + n`).
+                        m_finish = TinySTL::uninitialized_move_if_noexcept(pos, old_finish, m_finish);
+                        // Copy [`first`, `mid`) to [`pos`, `m_finish`).
+                        TinySTL::copy(first, mid, pos);
+                    }
+                }
+                // If there is not enough space.
+                else {
+                    // First allocate space.
+                    const size_type old_capacity = capacity();
+                    const size_type new_capacity = grown_capacity(n);
+                    iterator new_start           = vector_allocator::allocate(new_capacity);
+                    iterator new_finish          = new_start;
+                    try {
+                        // Move old [`m_start`, `pos`) to new space starting from `new_start`.
+                        new_finish = TinySTL::uninitialized_move_if_noexcept(m_start, pos, new_start);
+                        // Copy [`first`, `last`) to new space starting from `pos`.
+                        new_finish = TinySTL::uninitialized_copy(first, last, new_finish);
+                        // Move old [`pos`, `m_finish`) to new space starting from `pos + n`.
+                        new_finish = TinySTL::uninitialized_move_if_noexcept(pos, m_finish, new_finish);
+                    }
+                    catch (const std::exception&) {
+                        destory(new_start, new_finish);
+                        vector_allocator::deallocate(new_start, new_capacity);
+                        throw;
+                    }
+                    // Destroy and deallocation old space.
+                    destory(begin(), end());
+                    vector_allocator::deallocate(m_start, old_capacity);
+                    // Update the iterator.
+                    m_start          = new_start;
+                    m_finish         = new_finish;
+                    m_end_of_storage = new_start + new_capacity;
+                }
+            }
+        }
+
+        template <typename Integer>
+        void assign_dispatch(Integer n, Integer value, __true_type) {
+            assign((size_type)n, (T)value);
+        }
+
+        template <typename InputIterator>
+        void assign_dispatch(InputIterator first, InputIterator last, __false_type) {
+            range_assign(first, last, iterator_category(first));
+        }
+
+        /// @brief Assign an input range, overwrite the elements as the new ones come.
+        template <typename InputIterator>
+        void range_assign(InputIterator first, InputIterator last, input_iterator_tag) {
+            iterator curr = begin();
+            for (; first != last && curr != end(); ++first, ++curr) {
+                *curr = *first;
+            }
+            if (first == last) {
+                erase(curr, end());
+            }
+            else {
+                range_insert(end(), first, last, input_iterator_tag());
+            }
+        }
+
+        /// @brief Assign a forward range, reallocate at most once.
+        template <typename ForwardIterator>
+        void range_assign(ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+            const size_type n = TinySTL::distance(first, last);
+            // Not enough space, build the elements in a new space.
+            if (n > capacity()) {
+                iterator new_start  = vector_allocator::allocate(n);
+                iterator new_finish = new_start;
                 try {
-                    // Copy old [`m_start`, `pos`) to [`new_start`, `pos`).
-                    new_finish = TinySTL::uninitialized_copy(m_start, pos, new_start);
-                    // Put the inserted value.
-                    construct(new_finish);
-                    // Increment.
-                    ++new_finish;
-                    // copy old [`pos`, `m_finish`) to space starting from `pos + 1`, a.k.a `new_finish`.
-                    new_finish = TinySTL::uninitialized_copy(pos, m_finish, new_finish);
+                    new_finish = TinySTL::uninitialized_copy(first, last, new_start);
                 }
                 catch (const std::exception&) {
-                    // If fail to construct, destroy and deallocate.
-                    destory(new_start, new_finish);
-                    vector_allocator::deallocate(new_start, new_capacity);
+                    vector_allocator::deallocate(new_start, n);
                     throw;
                 }
-                // Destroy and deallocation old space.
-                destory(begin(), end());
-                vector_allocator::deallocate(m_start, old_capacity);
-                // Update the iterator.
+                destory(m_start, m_finish);
+                vector_allocator::deallocate(m_start, capacity());
                 m_start          = new_start;
                 m_finish         = new_finish;
-                m_end_of_storage = new_start + new_capacity;
+                m_end_of_storage = new_start + n;
+            }
+            // Shorter, overwrite and destroy the rest.
+            else if (n <= size()) {
+                erase(TinySTL::copy(first, last, m_start), end());
+            }
+            // Longer, overwrite and construct the rest.
+            else {
+                ForwardIterator mid = first;
+                TinySTL::advance(mid, size());
+                TinySTL::copy(first, mid, m_start);
+                m_finish = TinySTL::uninitialized_copy(mid, last, m_finish);
             }
         }
 
@@ -130,30 +294,51 @@ namespace TinySTL {
             , m_finish(nullptr)
             , m_end_of_storage(nullptr) {}
 
-        vector(size_type n, const T& value = value_type())
-            : m_start(vector_allocator::allocate(n))
+        explicit vector(const Alloc& a)
+            : vector_allocator(a)
+            , m_start(nullptr)
+            , m_finish(nullptr)
+            , m_end_of_storage(nullptr) {}
+
+        vector(size_type n, const T& value = value_type(), const Alloc& a = Alloc())
+            : vector_allocator(a)
+            , m_start(vector_allocator::allocate(n))
             , m_finish(TinySTL::uninitialized_fill_n(m_start, n, value))
             , m_end_of_storage(m_start + n) {}
 
+        /// @brief Construct `n` default initialized elements, trivial ones are left uninitialized.
+        vector(size_type n, default_init_t, const Alloc& a = Alloc())
+            : vector_allocator(a)
+            , m_start(vector_allocator::allocate(n))
+            , m_finish(TinySTL::uninitialized_default_n(m_start, n))
+            , m_end_of_storage(m_start + n) {}
+
         vector(const vector& other)
-            : m_start(vector_allocator::allocate(other.size()))
+            : vector_allocator(other.get_allocator())
+            , m_start(vector_allocator::allocate(other.size()))
             , m_finish(TinySTL::uninitialized_copy(other.m_start, other.m_finish, m_start))
             , m_end_of_storage(m_start + other.size()) {}
 
         vector(vector&& other) noexcept
-            : m_start(std::exchange(other.m_start, nullptr))
-            , m_finish(std::exchange(other.m_finish, nullptr))
-            , m_end_of_storage(std::exchange(other.m_end_of_storage, nullptr)) {}
-
-        vector(const value_type* first, const value_type* last)
-            : m_start(vector_allocator::allocate(std::distance(first, last)))
-            , m_finish(TinySTL::uninitialized_copy(first, last, m_start))
-            , m_end_of_storage(m_finish) {}
+            : vector_allocator(other.get_allocator())
+            , m_start(other.m_start)
+            , m_finish(other.m_finish)
+            , m_end_of_storage(other.m_end_of_storage) {
+            other.m_start          = nullptr;
+            other.m_finish         = nullptr;
+            other.m_end_of_storage = nullptr;
+        }
 
-        vector(const iterator first, const iterator last)
-            : m_start(vector_allocator::allocate(std::distance(first, last)))
-            , m_finish(TinySTL::uninitialized_copy(first, last, m_start))
-            , m_end_of_storage(m_finish) {}
+        /// @brief Construct from [`first`, `last`), or `first` copies of `last` if they are integers.
+        template <typename InputIterator>
+        vector(InputIterator first, InputIterator last, const Alloc& a = Alloc())
+            : vector_allocator(a)
+            , m_start(nullptr)
+            , m_finish(nullptr)
+            , m_end_of_storage(nullptr) {
+            using integral = typename __is_integer<InputIterator>::integral;
+            assign_dispatch(first, last, integral());
+        }
 
         vector& operator=(const vector& other) {
             if (this != &other) {
@@ -176,6 +361,8 @@ namespace TinySTL {
         }
 
     public:
+        allocator_type get_allocator() const { return vector_allocator::get_allocator(); }
+
         iterator begin() { return m_start; }
         iterator end() { return m_finish; }
         const_iterator begin() const { return m_start; }
@@ -206,62 +393,94 @@ namespace TinySTL {
             }
         }
 
+        /// @brief Move a `value` to the back of the vector.
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
         /// @brief Add a default value at the back of the vector.
         void push_back() {
+            emplace_back();
+        }
+
+        /// @brief Construct a value from `args` at the back of the vector.
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
             if (m_finish != m_end_of_storage) {
-                construct(m_finish);
+                construct(m_finish, std::forward<Args>(args)...);
                 ++m_finish;
             }
             else {
-                insert_aux(end());
+                insert_aux(end(), std::forward<Args>(args)...);
             }
+            return back();
         }
 
-        void pop_back() {
-            --m_finish;
-            destory(m_finish);
-        }
-
-        iterator insert(iterator pos, const T& value) {
+        /// @brief Construct a value from `args` at given `pos`.
+        template <typename... Args>
+        iterator emplace(iterator pos, Args&&... args) {
             size_type n = pos - begin();
             // Insert at `m_finish`.
             if (m_finish != m_end_of_storage && pos == end()) {
-                construct(m_finish, value);
+                construct(m_finish, std::forward<Args>(args)...);
                 ++m_finish;
             }
             // Insert at middle.
             else {
-                insert_aux(pos, value);
+                insert_aux(pos, std::forward<Args>(args)...);
             }
             return begin() + n;
         }
 
-        iterator insert(iterator pos) {
+        void pop_back() {
+            --m_finish;
+            destory(m_finish);
+        }
+
+        iterator insert(iterator pos, const T& value) {
             size_type n = pos - begin();
             // Insert at `m_finish`.
             if (m_finish != m_end_of_storage && pos == end()) {
-                construct(m_finish);
+                construct(m_finish, value);
                 ++m_finish;
             }
             // Insert at middle.
             else {
-                insert_aux(pos);
+                insert_aux(pos, value);
             }
             return begin() + n;
         }
 
-        void insert(iterator pos, size_type n, const T& value) {
+        iterator insert(iterator pos, T&& value) {
+            return emplace(pos, std::move(value));
+        }
+
+        iterator insert(iterator pos) {
+            return emplace(pos);
+        }
+
+        void insert(iterator pos, size_type n, const T& x) {
+            // Grow the buffer of relocatable elements by `Alloc::reallocate`, then insert in place.
+            if (__is_trivially_relocatable<T>::value && (size_type)(m_end_of_storage - m_finish) < n) {
+                T value(x);
+                const size_type offset = pos - m_start;
+                reallocate_storage(grown_capacity(n));
+                insert(m_start + offset, n, value);
+                return;
+            }
             if (n != 0) {
                 // If there is enough space.
                 if ((size_type)(m_end_of_storage - m_finish) >= n) {
+                    // Copy `x` first, since it may refer to an element being moved.
+                    T value(x);
                     const size_type n_elems_after = m_finish - pos;
                     iterator old_finish           = m_finish;
                     // If there are more elements after `pos` than number of inserted values.
                     if (n_elems_after > n) {
-                        // Copy [`m_finish - n`, `m_finish`) to [`m_finish`, `m_finish + n`).
-                        m_finish = TinySTL::uninitialized_copy(m_finish - n, m_finish, m_finish);
-                        // Copy [`pos`, `m_finish - n`) to [`pos + n`, `m_finish`).
-                        TinySTL::copy_backward(pos, old_finish - n, old_finish);
+                        // Move [`m_finish - n`, `m_finish`) to [`m_finish`, `m_finish + n`).
+                        m_finish = TinySTL::uninitialized_move_if_noexcept(m_finish - n, m_finish, m_finish);
+                        // Move [`pos`, `m_finish - n`) to [`pos + n`, `m_finish`).
+                        TinySTL::move_backward(pos, old_finish - n, old_finish);
                         // Fill [`pos`, `pos + n`) with `value`.
                         TinySTL::fill(pos, pos + n, value);
                     }
@@ -269,8 +488,8 @@ namespace TinySTL {
                     else {
                         // Fill [`m_finish`, `pos + n`) with `value`.
                         m_finish = TinySTL::uninitialized_fill_n(m_finish, n - n_elems_after, value);
-                        // Copy [`pos`, `m_finish`) to [`pos + n`, `m_finish + n`).
-                        m_finish = TinySTL::uninitialized_copy(pos, old_finish, m_finish);
+                        // Move [`pos`, `m_finish`) to [`pos + n`, `m_finish + n`).
+                        m_finish = TinySTL::uninitialized_move_if_noexcept(pos, old_finish, m_finish);
                         // Fill [`pos`, `m_finish`) with `value`.
                         TinySTL::fill(pos, old_finish, value);
                     }
@@ -278,18 +497,17 @@ namespace TinySTL {
                 // If there is not enough space.
                 else {
                     // First allocate space.
-                    const size_type old_size     = size();
                     const size_type old_capacity = capacity();
-                    const size_type new_capacity = old_size + n;
+                    const size_type new_capacity = grown_capacity(n);
                     iterator new_start           = vector_allocator::allocate(new_capacity);
                     iterator new_finish          = new_start;
                     try {
-                        // Copy old [`m_start`, `pos`) to new space starting from `new_start`.
-                        new_finish = TinySTL::uninitialized_copy(m_start, pos, new_start);
+                        // Move old [`m_start`, `pos`) to new space starting from `new_start`.
+                        new_finish = TinySTL::uninitialized_move_if_noexcept(m_start, pos, new_start);
                         // Put n inserted values.
-                        new_finish = TinySTL::uninitialized_fill_n(new_finish, n, value);
-                        // Copy old [`pos`, `m_finish`) to new space starting from `pos + n`.
-                        new_finish = TinySTL::uninitialized_copy(pos, m_finish, new_finish);
+                        new_finish = TinySTL::uninitialized_fill_n(new_finish, n, x);
+                        // Move old [`pos`, `m_finish`) to new space starting from `pos + n`.
+                        new_finish = TinySTL::uninitialized_move_if_noexcept(pos, m_finish, new_finish);
                     }
                     catch (const std::exception&) {
                         destory(new_start, new_finish);
@@ -307,76 +525,41 @@ namespace TinySTL {
             }
         }
 
+        /// @brief Insert [`first`, `last`), or `first` copies of `last` if they are integers.
         template <typename InputIterator>
         void insert(iterator pos, InputIterator first, InputIterator last) {
-            size_type n = TinySTL::distance(first, last);
-            if (n != 0) {
-                // If there is enough space.
-                if ((size_type)(m_end_of_storage - m_finish) >= n) {
-                    const size_type n_elems_after = m_finish - pos;
-                    iterator old_finish           = m_finish;
-                    // If there are more elements after `pos` than number of inserted values.
-                    if (n_elems_after > n) {
-                        // Copy [`m_finish - n`, `m_finish`) to [`m_finish`, `m_finish + n`).
-                        m_finish = TinySTL::uninitialized_copy(m_finish - n, m_finish, m_finish);
-                        // Copy [`pos`, `m_finish - n`) to [`pos + n`, `m_finish`).
-                        TinySTL::copy_backward(pos, old_finish - n, old_finish);
-                        // Copy [`first`, `last`) to [`pos`, `pos + n`).
-                        TinySTL::copy(first, last, pos);
-                    }
-                    // Otherwise, more inserted values.
-                    else {
-                        // Copy [`first + n_elems_after`, `last`) to [`m_finish`, `pos + n`).
-                        m_finish = TinySTL::uninitialized_copy(first + n_elems_after, last, m_finish);
-                        // Copy [`pos`, `m_finish`) to [`pos + n`, `m_finish + n`).
-                        m_finish = TinySTL::uninitialized_copy(pos, old_finish, m_finish);
-                        // Copy [`first`, `first + n_elems_after`) to [`pos`, `m_finish`).
-                        TinySTL::copy(first, first + n_elems_after, pos);
-                    }
-                }
-                // If there is not enough space.
-                else {
-                    // First allocate space.
-                    const size_type old_size     = size();
-                    const size_type old_capacity = capacity();
-                    const size_type new_capacity = old_size + n;
-                    iterator new_start           = vector_allocator::allocate(new_capacity);
-                    iterator new_finish          = new_start;
-                    try {
-                        // Copy old [`m_start`, `pos`) to new space starting from `new_start`.
-                        new_finish = TinySTL::uninitialized_copy(m_start, pos, new_start);
-                        // Copy old [`first`, `last`) to new space starting from `pos`.
-                        new_finish = TinySTL::uninitialized_copy(first, last, new_finish);
-                        // Copy old [`pos`, `m_finish`) to new space starting from `pos + n`.
-                        new_finish = TinySTL::uninitialized_copy(pos, m_finish, new_finish);
-                    }
-                    catch (const std::exception&) {
-                        destory(new_start, new_finish);
-                        vector_allocator::deallocate(new_start, new_capacity);
-                        throw;
-                    }
-                    // Destroy and deallocation old space.
-                    destory(begin(), end());
-                    vector_allocator::deallocate(m_start, old_capacity);
-                    // Update the iterator.
-                    m_start          = new_start;
-                    m_finish         = new_finish;
-                    m_end_of_storage = new_start + new_capacity;
-                }
-            }
+            using integral = typename __is_integer<InputIterator>::integral;
+            insert_dispatch(pos, first, last, integral());
+        }
+
+        /// @brief Replace the content with `n` copies of `value`.
+        void assign(size_type n, const T& value) {
+            vector temp(n, value, get_allocator());
+            swap(*this, temp);
+        }
+
+        /// @brief Replace the content with [`first`, `last`), or `first` copies of `last` if they are integers.
+        template <typename InputIterator>
+        void assign(InputIterator first, InputIterator last) {
+            using integral = typename __is_integer<InputIterator>::integral;
+            assign_dispatch(first, last, integral());
         }
 
         iterator erase(iterator pos) {
             if (pos + 1 != end()) {
-                copy(pos + 1, m_finish, pos);
+                TinySTL::move(pos + 1, m_finish, pos);
             }
             pop_back();
             return pos;
         }
 
         iterator erase(iterator first, iterator last) {
-            // Copy [`last`, `m_finish`) to [`first`, `m_finish - (last - first)`).
-            iterator new_finish = TinySTL::copy(last, m_finish, first);
+            // Moving the tail onto itself may empty the elements.
+            if (first == last) {
+                return first;
+            }
+            // Move [`last`, `m_finish`) to [`first`, `m_finish - (last - first)`).
+            iterator new_finish = TinySTL::move(last, m_finish, first);
             destory(new_finish, m_finish);
             m_finish = new_finish;
             return first;
@@ -395,13 +578,45 @@ namespace TinySTL {
             }
         }
 
+        /// @brief Resize to `new_size`, the new elements are default initialized, trivial ones are left uninitialized.
+        void resize_default_init(size_type new_size) {
+            if (new_size < size()) {
+                erase(begin() + new_size, end());
+            }
+            else {
+                append_uninitialized(new_size - size());
+            }
+        }
+
+        /// @brief Append `n` default initialized elements and return the first of them,
+        /// for the caller to fill in without writing them twice.
+        iterator append_uninitialized(size_type n) {
+            if ((size_type)(m_end_of_storage - m_finish) < n) {
+                reserve(grown_capacity(n));
+            }
+            iterator first = m_finish;
+            m_finish       = TinySTL::uninitialized_default_n(m_finish, n);
+            return first;
+        }
+
+        /// @brief Allocate space for at least `n` elements at once, so that inserting up to `n` elements does not reallocate.
         void reserve(size_type n) {
-            if (capacity() < n) {
+            if (capacity() < n && __is_trivially_relocatable<T>::value) {
+                reallocate_storage(n);
+            }
+            else if (capacity() < n) {
                 // Allocate new space.
                 const size_type old_capacity = capacity();
                 iterator new_start           = vector_allocator::allocate(n);
-                // Copy old space to new space.
-                iterator new_finish = uninitialized_copy(begin(), end(), new_start);
+                iterator new_finish          = new_start;
+                try {
+                    // Move old space to new space.
+                    new_finish = TinySTL::uninitialized_move_if_noexcept(begin(), end(), new_start);
+                }
+                catch (const std::exception&) {
+                    vector_allocator::deallocate(new_start, n);
+                    throw;
+                }
                 // Destroy and deallocate old space.
                 destory(m_start, m_finish);
                 vector_allocator::deallocate(m_start, old_capacity);
@@ -412,12 +627,20 @@ namespace TinySTL {
             }
         }
 
+        /// @brief Give back the unused capacity.
         void shrink_to_fit() {
             if (size() != capacity()) {
                 // Allocate new space.
-                iterator new_start = vector_allocator::allocate(size());
-                // Copy old space to new space.
-                iterator new_finish = TinySTL::uninitialized_copy(begin(), end(), new_start);
+                iterator new_start  = vector_allocator::allocate(size());
+                iterator new_finish = new_start;
+                try {
+                    // Move old space to new space.
+                    new_finish = TinySTL::uninitialized_move_if_noexcept(begin(), end(), new_start);
+                }
+                catch (const std::exception&) {
+                    vector_allocator::deallocate(new_start, size());
+                    throw;
+                }
                 destory(m_start, m_finish);
                 vector_allocator::deallocate(m_start, capacity());
                 // Update the iterator.
@@ -428,14 +651,14 @@ namespace TinySTL {
         }
 
         friend void swap(vector& lhs, vector& rhs) noexcept {
-            using TinySTL::swap;
-            swap(lhs.m_start, rhs.m_start);
-            swap(lhs.m_finish, rhs.m_finish);
-            swap(lhs.m_end_of_storage, rhs.m_end_of_storage);
+            TinySTL::swap(static_cast<vector_allocator&>(lhs), static_cast<vector_allocator&>(rhs));
+            TinySTL::swap(lhs.m_start, rhs.m_start);
+            TinySTL::swap(lhs.m_finish, rhs.m_finish);
+            TinySTL::swap(lhs.m_end_of_storage, rhs.m_end_of_storage);
         }
 
         friend bool operator==(const vector& lhs, const vector& rhs) noexcept {
-            return lhs.size() == rhs.size() && equal(lhs.begin(), lhs.end(), rhs.begin());
+            return lhs.size() == rhs.size() && TinySTL::equal(lhs.begin(), lhs.end(), rhs.begin());
         }
 
         friend bool operator!=(const vector& lhs, const vector& rhs) noexcept {
@@ -443,7 +666,7 @@ namespace TinySTL {
         }
 
         friend bool operator<(const vector& lhs, const vector& rhs) noexcept {
-            return lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+            return TinySTL::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
         }
 
         friend bool operator>(const vector& lhs, const vector& rhs) noexcept {
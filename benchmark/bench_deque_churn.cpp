@@ -0,0 +1,45 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <stl_deque.hpp>
+
+// Steady-state churn of a FIFO `deque`: push one element at the back, pop one at the front,
+// with the queue length kept constant, so its ends keep crossing buffer boundaries.
+// Compare buffers freed as soon as they empty (the default), two spare buffers, and page sized buffers.
+// Usage: bench_deque_churn [queue length] [number of operations]
+
+using no_spare = TinySTL::deque<int>;
+using spare    = TinySTL::deque<int, TinySTL::alloc, 0, TinySTL::__bytes_buffer_policy<512, 2>>;
+using page     = TinySTL::deque<int, TinySTL::alloc, 0, TinySTL::__page_buffer_policy<>>;
+
+template <typename Deque>
+void run(const char* name, size_t length, size_t ops) {
+    using clock = std::chrono::steady_clock;
+    Deque q;
+    for (size_t i = 0; i < length; ++i) {
+        q.push_back((int)i);
+    }
+
+    auto start = clock::now();
+    long long sum = 0;
+    for (size_t i = 0; i < ops; ++i) {
+        q.push_back((int)i);
+        sum += q.front();
+        q.pop_front();
+    }
+    auto done = clock::now();
+
+    double s = std::chrono::duration<double>(done - start).count();
+    std::printf("%-8s %8.3f s, %8.2f ns/op, checksum %lld\n", name, s, s / ops * 1e9, sum);
+}
+
+int main(int argc, char* argv[]) {
+    size_t length = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100;
+    size_t ops    = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000000;
+
+    run<no_spare>("no spare", length, ops);
+    run<spare>("spare", length, ops);
+    run<page>("page", length, ops);
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <stl_list.hpp>
+
+// Sort a `list` of random integers by the merge sort on the links (`sort`)
+// and by the introsort over an array of node pointers (`unstable_sort`).
+// The list is sorted once before timing, so its nodes are scattered in memory as in a long lived list.
+// Usage: bench_list_sort [number of elements]
+
+using clock_type = std::chrono::steady_clock;
+
+void refill(TinySTL::list<int>& l, unsigned seed) {
+    std::srand(seed);
+    for (auto it = l.begin(); it != l.end(); ++it) {
+        *it = std::rand();
+    }
+}
+
+template <typename Sort>
+void run(const char* name, TinySTL::list<int>& l, Sort sort) {
+    refill(l, 1);
+    auto start = clock_type::now();
+    sort(l);
+    auto done = clock_type::now();
+
+    double s = std::chrono::duration<double>(done - start).count();
+    std::printf("%-14s %8.3f s, %8.2f ns/element, front %d\n", name, s, s / l.size() * 1e9, l.front());
+}
+
+struct merge_sort {
+    void operator()(TinySTL::list<int>& l) const { l.sort(); }
+};
+
+struct array_sort {
+    void operator()(TinySTL::list<int>& l) const { l.unstable_sort(); }
+};
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    TinySTL::list<int> l;
+    for (size_t i = 0; i < n; ++i) {
+        l.push_back(0);
+    }
+    refill(l, 0);
+    l.sort();
+
+    run("sort", l, merge_sort());
+    run("unstable_sort", l, array_sort());
+    return 0;
+}
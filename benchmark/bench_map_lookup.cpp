@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <stl_map.hpp>
+
+// Lookup throughput of a large `map` whose nodes come from
+// the malloc chunk source and the huge page mmap chunk source.
+// Usage: bench_map_lookup [number of keys] [number of lookups]
+
+using malloc_pool = TinySTL::__default_alloc_template<false, 1, TinySTL::__linear_size_class<>, TinySTL::__adaptive_refill_policy<>, TinySTL::__malloc_chunk_source>;
+#ifdef TINYSTL_HAS_MMAP
+using mmap_pool = TinySTL::__default_alloc_template<false, 1, TinySTL::__linear_size_class<>, TinySTL::__adaptive_refill_policy<>, TinySTL::__mmap_chunk_source<>>;
+#endif
+
+template <typename Alloc>
+void run(const char* name, const std::vector<size_t>& keys, const std::vector<size_t>& queries) {
+    using clock = std::chrono::steady_clock;
+    TinySTL::map<size_t, size_t, TinySTL::less<size_t>, Alloc> m;
+
+    auto start = clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        m[keys[i]] = i;
+    }
+    auto built = clock::now();
+
+    size_t found = 0;
+    for (size_t key : queries) {
+        found += m.find(key) != m.end();
+    }
+    auto done = clock::now();
+
+    double build_s  = std::chrono::duration<double>(built - start).count();
+    double lookup_s = std::chrono::duration<double>(done - built).count();
+    std::printf("%-8s build %8.3f s, lookup %8.3f s, %8.3f M lookups/s, %zu found\n",
+        name, build_s, lookup_s, queries.size() / lookup_s / 1e6, found);
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    size_t q = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4000000;
+
+    std::mt19937_64 rng(42);
+    std::vector<size_t> keys(n), queries(q);
+    for (size_t& key : keys) {
+        key = rng();
+    }
+    // Half of the queries hit.
+    for (size_t i = 0; i < q; ++i) {
+        queries[i] = (i & 1) ? keys[rng() % n] : rng();
+    }
+
+    run<malloc_pool>("malloc", keys, queries);
+#ifdef TINYSTL_HAS_MMAP
+    run<mmap_pool>("mmap", keys, queries);
+#endif
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <stl_deque.hpp>
+#include <stl_list.hpp>
+#include <stl_unrolled_list.hpp>
+
+// Compare `unrolled_list` with `list` and `deque` on two workloads:
+// iterate over all the elements, and insert at the middle of the container.
+// The `list` is sorted by random keys before timing, so its nodes are scattered in memory as in a long lived list.
+// Usage: bench_unrolled_list [number of elements] [number of middle insertions]
+
+using clock_type = std::chrono::steady_clock;
+
+static double seconds_since(clock_type::time_point start) {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+template <typename Container>
+void iterate(const char* name, const Container& c) {
+    auto start    = clock_type::now();
+    long long sum = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (auto it = c.begin(); it != c.end(); ++it) {
+            sum += *it;
+        }
+    }
+    double s = seconds_since(start);
+    std::printf("iterate %-14s %8.3f s, %6.2f ns/element, checksum %lld\n", name, s, s / (10.0 * c.size()) * 1e9, sum);
+}
+
+// `list` and `unrolled_list` keep the iterator returned by the last insertion.
+template <typename Container>
+void insert_middle(const char* name, Container& c, size_t n) {
+    auto pos = c.begin();
+    TinySTL::advance(pos, c.size() / 2);
+    auto start = clock_type::now();
+    for (size_t i = 0; i < n; ++i) {
+        pos = c.insert(pos, (int)i);
+        if (i % 2 == 0) {
+            ++pos;
+        }
+    }
+    double s = seconds_since(start);
+    std::printf("insert  %-14s %8.3f s, %6.2f ns/insert\n", name, s, s / n * 1e9);
+}
+
+// `deque` has no stable position, so it inserts at the middle index every time.
+void insert_middle(const char* name, TinySTL::deque<int>& c, size_t n) {
+    auto start = clock_type::now();
+    for (size_t i = 0; i < n; ++i) {
+        c.insert(c.begin() + c.size() / 2, (int)i);
+    }
+    double s = seconds_since(start);
+    std::printf("insert  %-14s %8.3f s, %6.2f ns/insert\n", name, s, s / n * 1e9);
+}
+
+struct key_less {
+    bool operator()(int lhs, int rhs) const { return (unsigned)lhs * 2654435761u < (unsigned)rhs * 2654435761u; }
+};
+
+int main(int argc, char* argv[]) {
+    size_t n       = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t inserts = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+
+    TinySTL::list<int> l;
+    TinySTL::deque<int> d;
+    TinySTL::unrolled_list<int> u;
+    for (size_t i = 0; i < n; ++i) {
+        l.push_back((int)i);
+        d.push_back((int)i);
+        u.push_back((int)i);
+    }
+    // Scatter the nodes of the list.
+    l.sort(key_less());
+
+    iterate("list", l);
+    iterate("deque", d);
+    iterate("unrolled_list", u);
+
+    insert_middle("list", l, inserts);
+    insert_middle("deque", d, inserts);
+    insert_middle("unrolled_list", u, inserts);
+    return 0;
+}
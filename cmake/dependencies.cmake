@@ -5,4 +5,15 @@ if (CCACHE_FOUND)
     set_property(GLOBAL PROPERTY RULE_LAUNCH_LINK ccache)
 endif()
 
+# libnuma is optional, `stl_numa.hpp` falls back to `mbind` without it.
+# Only the targets including `stl_numa.hpp` add `NUMA_DEFINITIONS` and `NUMA_LIBRARIES`.
+find_library(NUMA_LIBRARY numa)
+find_path(NUMA_INCLUDE_DIR numa.h)
+if (NUMA_LIBRARY AND NUMA_INCLUDE_DIR)
+    message(STATUS "Using libnuma")
+    set(NUMA_DEFINITIONS TINYSTL_USE_LIBNUMA)
+    set(NUMA_INCLUDE_DIRS ${NUMA_INCLUDE_DIR})
+    set(NUMA_LIBRARIES ${NUMA_LIBRARY})
+endif()
+
 CPMAddPackage("gh:google/googletest@1.14.0")
@@ -0,0 +1,391 @@
+// The counters are compiled out unless this is defined before the first include.
+#define TINYSTL_ALLOC_STATS
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <set>
+#include <sstream>
+#include <stl_alloc.hpp>
+#include <stl_list.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Every test uses its own `inst`, so that it starts from an empty pool.
+
+TEST(TestAllocStats, Classes) {
+    using Alloc = TinySTL::__default_alloc_template<false, 40>;
+
+    void* p[3];
+    for (int i = 0; i < 3; ++i) {
+        p[i] = Alloc::allocate(24);
+    }
+    void* q = Alloc::allocate(20);
+    for (int i = 0; i < 3; ++i) {
+        Alloc::deallocate(p[i], 24);
+    }
+    Alloc::deallocate(q, 20);
+
+    Alloc::stats_type stats = Alloc::stats();
+    ASSERT_TRUE(stats.enabled);
+    const TinySTL::__alloc_class_stats& c = stats.classes[2];
+    EXPECT_EQ(c.size, 24u);
+    EXPECT_EQ(c.allocations, 4u);
+    EXPECT_EQ(c.deallocations, 4u);
+    // The first allocation refills the class, the others are served by the free list.
+    EXPECT_EQ(c.refills, 1u);
+    EXPECT_EQ(c.hits, 3u);
+    EXPECT_GE(c.refill_objects, 4u);
+    EXPECT_EQ(c.requested_bytes, 3 * 24u + 20u);
+    EXPECT_EQ(c.rounded_bytes, 4 * 24u);
+    EXPECT_EQ(stats.classes[0].allocations, 0u);
+
+    EXPECT_EQ(stats.chunks, 1u);
+    EXPECT_EQ(stats.heap_size, stats.chunk_bytes);
+    EXPECT_EQ(stats.large_allocations, 0u);
+}
+
+TEST(TestAllocStats, Large) {
+    using Alloc = TinySTL::__default_alloc_template<false, 41>;
+
+    char* p = (char*)Alloc::allocate(1000);
+    memset(p, 'x', 1000);
+    // Large to large goes to `realloc`, and is counted as one free and one allocation.
+    p = (char*)Alloc::reallocate(p, 1000, 5000);
+    EXPECT_EQ(p[999], 'x');
+    p = (char*)Alloc::reallocate(p, 5000, 2000);
+    EXPECT_EQ(p[999], 'x');
+
+    Alloc::stats_type stats = Alloc::stats();
+    EXPECT_EQ(stats.large_allocations, 3u);
+    EXPECT_EQ(stats.large_deallocations, 2u);
+    EXPECT_EQ(stats.large_bytes, 1000u + 5000u + 2000u);
+
+    // Large to small is a free of the large block and an allocation of the class.
+    p = (char*)Alloc::reallocate(p, 2000, 64);
+    EXPECT_EQ(p[63], 'x');
+    stats = Alloc::stats();
+    EXPECT_EQ(stats.large_allocations, 3u);
+    EXPECT_EQ(stats.large_deallocations, 3u);
+    EXPECT_EQ(stats.classes[7].allocations, 1u);
+    Alloc::deallocate(p, 64);
+    EXPECT_EQ(Alloc::stats().classes[7].deallocations, 1u);
+
+    std::ostringstream os;
+    Alloc::dump_stats(os);
+    EXPECT_NE(os.str().find("large: 3 allocs, 3 frees, 8000 bytes"), std::string::npos);
+}
+
+TEST(TestAllocThreads, RoundTrip) {
+    using Alloc = TinySTL::__default_alloc_template<true, 42>;
+
+    // Every thread frees the blocks of the next one, so that objects move between the caches through the depot.
+    const int threads = 4;
+    const int blocks  = 20000;
+    std::vector<std::vector<int*>> allocated(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&allocated, t] {
+            for (int i = 0; i < blocks; ++i) {
+                int* p = (int*)Alloc::allocate(sizeof(int) * (1 + i % 32));
+                for (int j = 0; j <= i % 32; ++j) {
+                    p[j] = t * blocks + i;
+                }
+                allocated[t].push_back(p);
+                // Some short-lived blocks, reused from the cache of this thread.
+                if (i % 3 == 0) {
+                    Alloc::deallocate(Alloc::allocate(40), 40);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    // No block was handed to two threads.
+    std::set<int*> unique;
+    for (int t = 0; t < threads; ++t) {
+        unique.insert(allocated[t].begin(), allocated[t].end());
+    }
+    EXPECT_EQ(unique.size(), (size_t)threads * blocks);
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&allocated, t] {
+            const int owner               = (t + 1) % threads;
+            const std::vector<int*>& mine = allocated[owner];
+            for (int i = 0; i < blocks; ++i) {
+                for (int j = 0; j <= i % 32; ++j) {
+                    ASSERT_EQ(mine[i][j], owner * blocks + i);
+                }
+                Alloc::deallocate(mine[i], sizeof(int) * (1 + i % 32));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    Alloc::stats_type stats = Alloc::stats();
+    for (const TinySTL::__alloc_class_stats& c : stats.classes) {
+        EXPECT_EQ(c.allocations, c.deallocations) << "class " << c.size;
+    }
+    // The caches went back to the depot when their threads exited, so every chunk is free.
+    EXPECT_GT(stats.heap_size, 0u);
+    EXPECT_EQ(Alloc::trim(), stats.heap_size);
+    EXPECT_EQ(Alloc::stats().heap_size, 0u);
+}
+
+TEST(TestAllocTrim, ReleaseFreeChunks) {
+    using Alloc = TinySTL::__default_alloc_template<false, 43>;
+    EXPECT_EQ(Alloc::trim(), 0u);
+
+    std::vector<char*> blocks;
+    for (int i = 0; i < 20000; ++i) {
+        blocks.push_back((char*)Alloc::allocate(32));
+        blocks.back()[0] = (char)i;
+    }
+    Alloc::stats_type stats = Alloc::stats();
+    ASSERT_GT(stats.chunks, 1u);
+    const size_t heap_size = stats.heap_size;
+
+    // A live block keeps its chunk.
+    char* kept = blocks.back();
+    blocks.pop_back();
+    for (char* p : blocks) {
+        Alloc::deallocate(p, 32);
+    }
+    size_t released = Alloc::trim();
+    EXPECT_GT(released, 0u);
+    EXPECT_LT(released, heap_size);
+    EXPECT_EQ(Alloc::stats().heap_size, heap_size - released);
+    EXPECT_EQ(kept[0], (char)19999);
+    EXPECT_EQ(Alloc::trim(), 0u);
+
+    // The pool still works after a trim.
+    char* p = (char*)Alloc::allocate(32);
+    Alloc::deallocate(p, 32);
+    Alloc::deallocate(kept, 32);
+    released += Alloc::trim();
+    EXPECT_EQ(released, heap_size);
+    EXPECT_EQ(Alloc::stats().heap_size, 0u);
+    EXPECT_EQ(Alloc::stats().released_bytes, heap_size);
+}
+
+template <typename SizeClass>
+static void CheckSizeClass() {
+    // Every size maps to the smallest class holding it.
+    for (size_t bytes = 1; bytes <= (size_t)SizeClass::_MAX_BYTES; ++bytes) {
+        size_t index = SizeClass::index(bytes);
+        ASSERT_LT(index, (size_t)SizeClass::_NFREELISTS) << bytes << " bytes";
+        ASSERT_GE(SizeClass::size(index), bytes) << bytes << " bytes";
+        ASSERT_EQ(SizeClass::size(index) % SizeClass::_ALIGN, 0u) << bytes << " bytes";
+        if (index != 0) {
+            ASSERT_LT(SizeClass::size(index - 1), bytes) << bytes << " bytes";
+        }
+    }
+    EXPECT_EQ(SizeClass::size(SizeClass::_NFREELISTS - 1), (size_t)SizeClass::_MAX_BYTES);
+}
+
+template <typename Alloc, size_t Align, size_t MaxBytes>
+static void CheckAlignment() {
+    // Several blocks of every size, interleaved so that the classes share chunks and leftovers.
+    std::vector<std::pair<char*, size_t>> blocks;
+    for (int round = 0; round < 8; ++round) {
+        for (size_t bytes = 1; bytes <= MaxBytes; ++bytes) {
+            char* p = (char*)Alloc::allocate(bytes);
+            ASSERT_EQ((size_t)p % Align, 0u) << bytes << " bytes";
+            memset(p, (int)(bytes & 0xff), bytes);
+            blocks.push_back({ p, bytes });
+        }
+    }
+    for (auto& block : blocks) {
+        for (size_t i = 0; i < block.second; ++i) {
+            ASSERT_EQ((unsigned char)block.first[i], (unsigned char)(block.second & 0xff));
+        }
+        Alloc::deallocate(block.first, block.second);
+    }
+}
+
+TEST(TestAllocSizeClass, Linear) {
+    using SizeClass = TinySTL::__linear_size_class<>;
+    EXPECT_EQ((size_t)SizeClass::_NFREELISTS, 16u);
+    CheckSizeClass<SizeClass>();
+    CheckSizeClass<TinySTL::__linear_size_class<16, 256>>();
+    CheckAlignment<TinySTL::__default_alloc_template<false, 44, SizeClass>, 8, 128>();
+    CheckAlignment<TinySTL::__default_alloc_template<false, 45, TinySTL::__linear_size_class<16, 256>>, 16, 256>();
+}
+
+TEST(TestAllocSizeClass, Geometric) {
+    using SizeClass = TinySTL::__geometric_size_class<>;
+    // 8 classes up to 128, then 4 for each power of 2 up to 4096.
+    EXPECT_EQ((size_t)SizeClass::_NFREELISTS, 8u + 4 * 5);
+    EXPECT_EQ(SizeClass::size(8), 160u);
+    EXPECT_EQ(SizeClass::size(11), 256u);
+    EXPECT_EQ(SizeClass::index(257), 12u);
+    CheckSizeClass<SizeClass>();
+    CheckSizeClass<TinySTL::__geometric_size_class<8, 64, 1024>>();
+    CheckAlignment<TinySTL::__default_alloc_template<false, 46, SizeClass>, 16, 4096>();
+    CheckAlignment<TinySTL::__default_alloc_template<true, 47, TinySTL::__geometric_size_class<8, 64, 1024>>, 8, 1024>();
+}
+
+TEST(TestAllocRefill, Policies) {
+    using Fixed = TinySTL::__fixed_refill_policy<20>;
+    EXPECT_EQ(Fixed::initial(8), 20);
+    EXPECT_EQ(Fixed::next(20, 1, 8), 20);
+    EXPECT_EQ(Fixed::next(20, 1000, 8), 20);
+
+    using Adaptive = TinySTL::__adaptive_refill_policy<20, 4, 512>;
+    EXPECT_EQ(Adaptive::initial(8), 20);
+    // The first batch holds no more than 2048 bytes, and at least `Min` objects.
+    EXPECT_EQ(Adaptive::initial(256), 8);
+    EXPECT_EQ(Adaptive::initial(4096), 4);
+    // Hot classes double up to `Max` objects or 64K bytes, cold ones halve down to `Min`.
+    EXPECT_EQ(Adaptive::next(20, 1, 8), 40);
+    EXPECT_EQ(Adaptive::next(400, 2, 8), 512);
+    EXPECT_EQ(Adaptive::next(200, 1, 1024), 64);
+    EXPECT_EQ(Adaptive::next(20, 10, 8), 20);
+    EXPECT_EQ(Adaptive::next(20, 64, 8), 10);
+    EXPECT_EQ(Adaptive::next(6, 100, 8), 4);
+}
+
+template <typename Alloc>
+static TinySTL::__alloc_class_stats RefillHotClass(size_t n, size_t bytes) {
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < n; ++i) {
+        blocks.push_back(Alloc::allocate(bytes));
+    }
+    for (void* p : blocks) {
+        Alloc::deallocate(p, bytes);
+    }
+    return Alloc::stats().classes[bytes / 8 - 1];
+}
+
+TEST(TestAllocRefill, AdaptiveGrowth) {
+    using Fixed    = TinySTL::__default_alloc_template<false, 48, TinySTL::__linear_size_class<>, TinySTL::__fixed_refill_policy<20>>;
+    using Adaptive = TinySTL::__default_alloc_template<false, 49, TinySTL::__linear_size_class<>, TinySTL::__adaptive_refill_policy<20, 4, 512>>;
+
+    TinySTL::__alloc_class_stats fixed = RefillHotClass<Fixed>(10000, 16);
+    EXPECT_GE(fixed.refills, 10000u / 20);
+    EXPECT_GE(fixed.refill_objects, 10000u);
+
+    // 20, 40, ..., 320, then up to 512 objects per refill, fewer when a chunk runs short.
+    TinySTL::__alloc_class_stats adaptive = RefillHotClass<Adaptive>(10000, 16);
+    EXPECT_GE(adaptive.refill_objects, 10000u);
+    EXPECT_LT(adaptive.refills, fixed.refills / 10);
+    EXPECT_GT(adaptive.refill_objects / adaptive.refills, 200u);
+}
+
+#ifdef TINYSTL_HAS_MMAP
+TEST(TestAllocChunkSource, Mmap) {
+    using Source = TinySTL::__mmap_chunk_source<64 * 1024>;
+
+    size_t bytes = 100 * 1024;
+    char* chunk  = (char*)Source::try_allocate(bytes);
+    ASSERT_NE(chunk, nullptr);
+    // Rounded up to whole pages, and aligned to a page.
+    EXPECT_EQ(bytes, 128 * 1024u);
+    EXPECT_EQ((size_t)chunk % (64 * 1024), 0u);
+    memset(chunk, 'x', bytes);
+    EXPECT_EQ(chunk[bytes - 1], 'x');
+    Source::deallocate(chunk, bytes);
+
+    // A pool on the source uses all the rounded bytes, and gives them back by `munmap`.
+    using Alloc = TinySTL::__default_alloc_template<false, 50, TinySTL::__linear_size_class<>, TinySTL::__adaptive_refill_policy<>, TinySTL::__mmap_chunk_source<>>;
+    std::vector<char*> blocks;
+    for (int i = 0; i < 100000; ++i) {
+        blocks.push_back((char*)Alloc::allocate(48));
+        blocks.back()[47] = (char)i;
+    }
+    Alloc::stats_type stats = Alloc::stats();
+    EXPECT_GE(stats.chunks, 1u);
+    EXPECT_GE(stats.chunk_bytes, stats.chunks * (2 * 1024 * 1024 - 64));
+    for (int i = 0; i < 100000; ++i) {
+        ASSERT_EQ(blocks[i][47], (char)i);
+        Alloc::deallocate(blocks[i], 48);
+    }
+    EXPECT_EQ(Alloc::trim(), stats.heap_size);
+}
+#endif
+
+// A chain of `n` blocks of `bytes` bytes from `Alloc`.
+template <typename Alloc>
+static TinySTL::__node_chain<void*> MakeChain(size_t n, size_t bytes, std::set<void*>& blocks) {
+    TinySTL::__node_chain<void*> chain;
+    for (size_t i = 0; i < n; ++i) {
+        void** p = (void**)Alloc::allocate(bytes);
+        blocks.insert(p);
+        chain.push(p);
+    }
+    return chain;
+}
+
+TEST(TestAllocChain, DeallocateChain) {
+    using Alloc = TinySTL::__default_alloc_template<false, 51>;
+
+    std::set<void*> blocks;
+    TinySTL::__node_chain<void*> chain = MakeChain<Alloc>(1000, 24, blocks);
+    EXPECT_EQ(chain.count, 1000u);
+    Alloc::deallocate_chain(chain.head, chain.tail, chain.count, 24);
+    Alloc::stats_type stats = Alloc::stats();
+    EXPECT_EQ(stats.classes[2].deallocations, 1000u);
+
+    // The whole chain is on the free list, and handed out again without a refill.
+    for (int i = 0; i < 1000; ++i) {
+        void* p = Alloc::allocate(24);
+        EXPECT_EQ(blocks.erase(p), 1u);
+    }
+    EXPECT_EQ(Alloc::stats().classes[2].refills, stats.classes[2].refills);
+
+    // Large blocks are freed one by one.
+    chain = MakeChain<Alloc>(10, 1000, blocks);
+    Alloc::deallocate_chain(chain.head, chain.tail, chain.count, 1000);
+    EXPECT_EQ(Alloc::stats().large_deallocations, 10u);
+    Alloc::deallocate_chain(nullptr, nullptr, 0, 24);
+}
+
+TEST(TestAllocChain, ThreadCache) {
+    using Alloc = TinySTL::__default_alloc_template<true, 52>;
+
+    // A short chain goes to the cache of the thread, a long one to the depot.
+    // Either way the blocks are reused, no chunk is added to get them again.
+    for (size_t n : { 5, 5000 }) {
+        std::set<void*> blocks;
+        TinySTL::__node_chain<void*> chain = MakeChain<Alloc>(n, 40, blocks);
+        Alloc::deallocate_chain(chain.head, chain.tail, chain.count, 40);
+        size_t heap_size = Alloc::stats().heap_size;
+        for (size_t i = 0; i < n; ++i) {
+            Alloc::allocate(40);
+        }
+        EXPECT_EQ(Alloc::stats().heap_size, heap_size);
+    }
+    Alloc::stats_type stats = Alloc::stats();
+    EXPECT_EQ(stats.classes[4].deallocations, 5005u);
+}
+
+TEST(TestAllocChain, Containers) {
+    using Alloc = TinySTL::__default_alloc_template<false, 53>;
+
+    TinySTL::list<int, Alloc> list;
+    for (int i = 0; i < 1000; ++i) {
+        list.push_back(i);
+    }
+    Alloc::stats_type before = Alloc::stats();
+    list.clear();
+    Alloc::stats_type after = Alloc::stats();
+    size_t freed            = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        freed += after.classes[i].deallocations - before.classes[i].deallocations;
+    }
+    EXPECT_EQ(freed, 1000u);
+
+    // An allocator without `deallocate_chain` gets the nodes one by one.
+    TinySTL::list<int, TinySTL::malloc_alloc> plain;
+    for (int i = 0; i < 1000; ++i) {
+        plain.push_back(i);
+    }
+    plain.clear();
+    EXPECT_TRUE(plain.empty());
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stl_debug_alloc.hpp>
+#include <stl_vector.hpp>
+#include <string>
+#include <vector>
+
+// Constructed before the first debug allocation, so destroyed after everything the tests touch.
+// Its blocks are freed during static destruction and must still find the registry alive.
+TinySTL::vector<int, TinySTL::debug_alloc> g_vector;
+
+struct Error {
+    std::string what;
+    const void* ptr;
+};
+
+static std::vector<Error> g_errors;
+
+static void RecordError(const char* what, const void* ptr, const void*) {
+    g_errors.push_back(Error{ what, ptr });
+}
+
+class TestDebugAlloc : public testing::Test {
+protected:
+    using Alloc = TinySTL::debug_alloc;
+
+    void (*m_old_handler)(const char*, const void*, const void*);
+    size_t m_live_blocks;
+    size_t m_live_bytes;
+
+protected:
+    virtual void SetUp() override {
+        g_errors.clear();
+        m_old_handler = Alloc::set_error_handler(&RecordError);
+        m_live_blocks = Alloc::live_blocks();
+        m_live_bytes  = Alloc::live_bytes();
+    }
+
+    virtual void TearDown() override {
+        Alloc::set_error_handler(m_old_handler);
+    }
+
+    // Push every freed block so far out of the quarantine, which checks its poison.
+    static void FlushQuarantine() {
+        for (int i = 0; i < 128; ++i) {
+            Alloc::deallocate(Alloc::allocate(8), 8);
+        }
+    }
+};
+
+TEST_F(TestDebugAlloc, RoundTrip) {
+    char* p = (char*)Alloc::allocate(100);
+    for (int i = 0; i < 100; ++i) {
+        p[i] = (char)i;
+    }
+    p = (char*)Alloc::reallocate(p, 100, 300);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(p[i], (char)i);
+    }
+    Alloc::deallocate(p, 300);
+    FlushQuarantine();
+    EXPECT_TRUE(g_errors.empty());
+    EXPECT_EQ(Alloc::live_blocks(), m_live_blocks);
+}
+
+TEST_F(TestDebugAlloc, DoubleFree) {
+    void* p = Alloc::allocate(32);
+    Alloc::deallocate(p, 32);
+    EXPECT_TRUE(g_errors.empty());
+    Alloc::deallocate(p, 32);
+    ASSERT_EQ(g_errors.size(), 1u);
+    EXPECT_EQ(g_errors[0].what, "double free");
+    EXPECT_EQ(g_errors[0].ptr, p);
+}
+
+TEST_F(TestDebugAlloc, SizeMismatch) {
+    void* p = Alloc::allocate(32);
+    Alloc::deallocate(p, 16);
+    ASSERT_EQ(g_errors.size(), 1u);
+    EXPECT_EQ(g_errors[0].what, "size mismatch on free");
+}
+
+TEST_F(TestDebugAlloc, WritePastTheEnd) {
+    char* p = (char*)Alloc::allocate(24);
+    p[24]   = 'x';
+    Alloc::deallocate(p, 24);
+    ASSERT_EQ(g_errors.size(), 1u);
+    EXPECT_EQ(g_errors[0].what, "write past the end");
+    EXPECT_EQ(g_errors[0].ptr, p);
+}
+
+TEST_F(TestDebugAlloc, WriteAfterFree) {
+    FlushQuarantine();
+    char* p = (char*)Alloc::allocate(40);
+    Alloc::deallocate(p, 40);
+    // The block is still quarantined, so the write lands in memory the allocator owns.
+    p[7] = 'x';
+    EXPECT_TRUE(g_errors.empty());
+    FlushQuarantine();
+    ASSERT_EQ(g_errors.size(), 1u);
+    EXPECT_EQ(g_errors[0].what, "write after free");
+    EXPECT_EQ(g_errors[0].ptr, p);
+}
+
+TEST_F(TestDebugAlloc, LiveBlocksAndLeaks) {
+    void* p = Alloc::allocate(24);
+    void* q = Alloc::allocate(1000);
+    EXPECT_EQ(Alloc::live_blocks(), m_live_blocks + 2);
+    EXPECT_EQ(Alloc::live_bytes(), m_live_bytes + 1024);
+
+    std::ostringstream os;
+    EXPECT_EQ(Alloc::report_leaks(os), m_live_blocks + 2);
+    EXPECT_NE(os.str().find("leak of 24 bytes"), std::string::npos);
+    EXPECT_NE(os.str().find("leak of 1000 bytes"), std::string::npos);
+
+    Alloc::deallocate(p, 24);
+    Alloc::deallocate(q, 1000);
+    EXPECT_EQ(Alloc::live_blocks(), m_live_blocks);
+    EXPECT_EQ(Alloc::live_bytes(), m_live_bytes);
+    EXPECT_TRUE(g_errors.empty());
+}
+
+TEST_F(TestDebugAlloc, Container) {
+    {
+        TinySTL::vector<std::string, Alloc> strings;
+        for (int i = 0; i < 1000; ++i) {
+            strings.push_back(std::to_string(i));
+        }
+        strings.erase(strings.begin() + 10, strings.begin() + 500);
+        strings.shrink_to_fit();
+        EXPECT_GT(Alloc::live_blocks(), m_live_blocks);
+    }
+    EXPECT_EQ(Alloc::live_blocks(), m_live_blocks);
+
+    // Left allocated until static destruction.
+    for (int i = 0; i < 100; ++i) {
+        g_vector.push_back(i);
+    }
+    FlushQuarantine();
+    EXPECT_TRUE(g_errors.empty());
+}
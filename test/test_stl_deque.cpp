@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <stl_deque.hpp>
+#include <stl_numeric.hpp>
+#include <string>
+
+class TestDeque : public testing::Test {
+protected:
+    // Small buffers, so that the ranges cross buffer boundaries.
+    TinySTL::deque<std::string, TinySTL::alloc, 4> m_strings;
+    std::deque<std::string> m_expected;
+
+protected:
+    virtual void SetUp() override {
+        // Long enough to live on the heap, so that a self-moved string is emptied.
+        for (int i = 0; i < 50; ++i) {
+            m_strings.push_back("string number " + std::to_string(i) + " of the deque");
+            m_expected.push_back(m_strings.back());
+        }
+    }
+
+    void ExpectEqual() const {
+        ASSERT_EQ(m_strings.size(), m_expected.size());
+        for (size_t i = 0; i < m_expected.size(); ++i) {
+            EXPECT_EQ(m_strings[i], m_expected[i]) << "at " << i;
+        }
+    }
+};
+
+TEST_F(TestDeque, EraseEmptyRange) {
+    // One in the first half and one in the second half.
+    EXPECT_EQ(m_strings.erase(m_strings.begin() + 10, m_strings.begin() + 10), m_strings.begin() + 10);
+    EXPECT_EQ(m_strings.erase(m_strings.begin() + 40, m_strings.begin() + 40), m_strings.begin() + 40);
+    m_strings.erase(m_strings.begin(), m_strings.begin());
+    m_strings.erase(m_strings.end(), m_strings.end());
+    ExpectEqual();
+}
+
+TEST_F(TestDeque, Erase) {
+    m_strings.erase(m_strings.begin() + 5, m_strings.begin() + 15);
+    m_expected.erase(m_expected.begin() + 5, m_expected.begin() + 15);
+    ExpectEqual();
+
+    m_strings.erase(m_strings.begin() + 30, m_strings.begin() + 37);
+    m_expected.erase(m_expected.begin() + 30, m_expected.begin() + 37);
+    ExpectEqual();
+
+    m_strings.erase(m_strings.begin() + 3);
+    m_expected.erase(m_expected.begin() + 3);
+    m_strings.erase(m_strings.end() - 3);
+    m_expected.erase(m_expected.end() - 3);
+    ExpectEqual();
+
+    m_strings.erase(m_strings.begin(), m_strings.end());
+    EXPECT_TRUE(m_strings.empty());
+}
+
+TEST_F(TestDeque, Insert) {
+    m_strings.insert(m_strings.begin() + 3, std::string("inserted"));
+    m_expected.insert(m_expected.begin() + 3, std::string("inserted"));
+    m_strings.insert(m_strings.end() - 3, std::string("inserted"));
+    m_expected.insert(m_expected.end() - 3, std::string("inserted"));
+    ExpectEqual();
+
+    m_strings.insert(m_strings.begin() + 20, 30, std::string("filled"));
+    m_expected.insert(m_expected.begin() + 20, 30, std::string("filled"));
+    m_strings.insert(m_strings.begin() + 70, 5, std::string("filled"));
+    m_expected.insert(m_expected.begin() + 70, 5, std::string("filled"));
+    ExpectEqual();
+
+    std::string data[] = { "a", "b", "c", "d", "e", "f" };
+    m_strings.insert(m_strings.begin() + 2, std::begin(data), std::end(data));
+    m_expected.insert(m_expected.begin() + 2, std::begin(data), std::end(data));
+    m_strings.insert(m_strings.end() - 2, std::begin(data), std::end(data));
+    m_expected.insert(m_expected.end() - 2, std::begin(data), std::end(data));
+    m_strings.insert(m_strings.begin() + 5, std::begin(data), std::begin(data));
+    ExpectEqual();
+}
+
+TEST_F(TestDeque, PushPopAppendPrepend) {
+    for (int i = 0; i < 20; ++i) {
+        m_strings.push_front(std::to_string(i));
+        m_expected.push_front(std::to_string(i));
+    }
+    m_strings.pop_back();
+    m_expected.pop_back();
+    m_strings.pop_front();
+    m_expected.pop_front();
+    ExpectEqual();
+
+    std::string data[] = { "a", "b", "c", "d", "e", "f", "g", "h", "i" };
+    m_strings.append(std::begin(data), std::end(data));
+    m_expected.insert(m_expected.end(), std::begin(data), std::end(data));
+    m_strings.prepend(std::begin(data), std::end(data));
+    m_expected.insert(m_expected.begin(), std::begin(data), std::end(data));
+    ExpectEqual();
+}
+
+TEST_F(TestDeque, CopyAndMove) {
+    TinySTL::deque<std::string, TinySTL::alloc, 4> copied(m_strings);
+    EXPECT_TRUE(copied == m_strings);
+
+    TinySTL::deque<std::string, TinySTL::alloc, 4> moved(std::move(copied));
+    EXPECT_TRUE(moved == m_strings);
+    EXPECT_TRUE(copied.empty());
+}
+
+TEST(TestDequeSpare, Churn) {
+    TinySTL::deque<int, TinySTL::alloc, 0, TinySTL::__bytes_buffer_policy<64, 2>> queue;
+    std::deque<int> expected;
+    for (int i = 0; i < 10000; ++i) {
+        queue.push_back(i);
+        expected.push_back(i);
+        if (i % 3 == 0) {
+            queue.pop_front();
+            expected.pop_front();
+        }
+    }
+    queue.shrink_to_fit();
+    ASSERT_EQ(queue.size(), expected.size());
+    EXPECT_TRUE(TinySTL::equal(queue.begin(), queue.end(), expected.begin()));
+}
+
+class TestDequeSegmented : public testing::Test {
+protected:
+    // 8 ints per buffer, so that 100 elements span 13 or more buffers.
+    TinySTL::deque<int, TinySTL::alloc, 8> m_ints;
+
+protected:
+    virtual void SetUp() override {
+        // Fill from both ends, so that the first buffer starts in the middle.
+        for (int i = 49; i >= 0; --i) {
+            m_ints.push_front(i);
+        }
+        for (int i = 50; i < 100; ++i) {
+            m_ints.push_back(i);
+        }
+    }
+};
+
+TEST_F(TestDequeSegmented, Copy) {
+    int out[100] = {};
+    EXPECT_EQ(TinySTL::copy(m_ints.begin(), m_ints.end(), out), out + 100);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(out[i], i);
+    }
+
+    // A sub-range starting and ending inside buffers, and one within a single buffer.
+    int part[100] = {};
+    EXPECT_EQ(TinySTL::copy(m_ints.begin() + 5, m_ints.begin() + 37, part), part + 32);
+    for (int i = 0; i < 32; ++i) {
+        EXPECT_EQ(part[i], i + 5);
+    }
+    EXPECT_EQ(TinySTL::copy(m_ints.begin() + 51, m_ints.begin() + 53, part), part + 2);
+    EXPECT_EQ(part[0], 51);
+    EXPECT_EQ(part[1], 52);
+    EXPECT_EQ(TinySTL::copy(m_ints.begin() + 9, m_ints.begin() + 9, part), part);
+
+    // Both sides segmented.
+    TinySTL::deque<int, TinySTL::alloc, 8> copied(100, 0);
+    EXPECT_TRUE(TinySTL::copy(m_ints.begin(), m_ints.end(), copied.begin()) == copied.end());
+    EXPECT_TRUE(copied == m_ints);
+}
+
+TEST_F(TestDequeSegmented, Fill) {
+    TinySTL::fill(m_ints.begin() + 3, m_ints.begin() + 70, -1);
+    TinySTL::fill(m_ints.begin() + 90, m_ints.begin() + 92, -2);
+    TinySTL::fill(m_ints.begin() + 95, m_ints.begin() + 95, -3);
+    for (int i = 0; i < 100; ++i) {
+        int expected = (i >= 3 && i < 70) ? -1 : (i >= 90 && i < 92) ? -2 : i;
+        EXPECT_EQ(m_ints[i], expected) << "at " << i;
+    }
+}
+
+TEST_F(TestDequeSegmented, Find) {
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(TinySTL::find(m_ints.begin(), m_ints.end(), i) == m_ints.begin() + i) << "for " << i;
+    }
+    EXPECT_TRUE(TinySTL::find(m_ints.begin(), m_ints.end(), 100) == m_ints.end());
+
+    // Misses in sub-ranges return their own last.
+    auto first = m_ints.begin() + 10;
+    auto last  = m_ints.begin() + 60;
+    EXPECT_TRUE(TinySTL::find(first, last, 5) == last);
+    EXPECT_TRUE(TinySTL::find(first, last, 60) == last);
+    EXPECT_TRUE(TinySTL::find(first, last, 59) == last - 1);
+    EXPECT_TRUE(TinySTL::find(first, last, 10) == first);
+    EXPECT_TRUE(TinySTL::find(first + 1, first + 3, 12) == first + 2);
+    EXPECT_TRUE(TinySTL::find(first + 1, first + 3, 13) == first + 3);
+    EXPECT_TRUE(TinySTL::find(first, first, 10) == first);
+}
+
+struct CountCalls {
+    int count = 0;
+    void operator()(int) { ++count; }
+};
+
+TEST_F(TestDequeSegmented, ForEach) {
+    // A lambda cannot be assigned, so this only compiles when the functor is carried by reference.
+    long sum = 0;
+    TinySTL::for_each(m_ints.begin(), m_ints.end(), [&](int x) { sum += x; });
+    EXPECT_EQ(sum, 4950);
+
+    sum = 0;
+    TinySTL::for_each(m_ints.begin() + 5, m_ints.begin() + 37, [&](int x) { sum += x; });
+    EXPECT_EQ(sum, (5 + 36) * 32 / 2);
+
+    // The state of the functor is carried across the buffers and returned.
+    EXPECT_EQ(TinySTL::for_each(m_ints.begin(), m_ints.end(), CountCalls()).count, 100);
+    EXPECT_EQ(TinySTL::for_each(m_ints.begin() + 3, m_ints.begin() + 90, CountCalls()).count, 87);
+    EXPECT_EQ(TinySTL::for_each(m_ints.begin() + 3, m_ints.begin() + 5, CountCalls()).count, 2);
+    EXPECT_EQ(TinySTL::for_each(m_ints.begin() + 3, m_ints.begin() + 3, CountCalls()).count, 0);
+
+    TinySTL::for_each(m_ints.begin(), m_ints.end(), [](int& x) { x *= 2; });
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(m_ints[i], 2 * i);
+    }
+}
+
+TEST_F(TestDequeSegmented, Accumulate) {
+    EXPECT_EQ(TinySTL::accumulate(m_ints.begin(), m_ints.end(), 0), 4950);
+    EXPECT_EQ(TinySTL::accumulate(m_ints.begin() + 5, m_ints.begin() + 37, 0), (5 + 36) * 32 / 2);
+    EXPECT_EQ(TinySTL::accumulate(m_ints.begin() + 51, m_ints.begin() + 53, 1), 1 + 51 + 52);
+    EXPECT_EQ(TinySTL::accumulate(m_ints.begin() + 7, m_ints.begin() + 7, 42), 42);
+
+    auto max = [](int acc, int x) { return x > acc ? x : acc; };
+    EXPECT_EQ(TinySTL::accumulate(m_ints.begin(), m_ints.end(), -1, max), 99);
+    EXPECT_EQ(TinySTL::accumulate(m_ints.begin() + 20, m_ints.begin() + 41, -1, max), 40);
+}
@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+
+#include <stl_intrusive_list.hpp>
+#include <vector>
+
+// On two doubly linked lists and one singly linked list at the same time, by member hooks.
+struct Item {
+    int value;
+    TinySTL::intrusive_list_hook lru;
+    TinySTL::intrusive_list_hook bucket;
+    TinySTL::intrusive_forward_list_hook free;
+
+    explicit Item(int v = 0)
+        : value(v) {}
+
+    friend bool operator<(const Item& lhs, const Item& rhs) { return lhs.value < rhs.value; }
+};
+
+// One list by its base hook, another by a member hook.
+struct BaseItem : public TinySTL::intrusive_list_hook, public TinySTL::intrusive_forward_list_hook {
+    int value;
+    TinySTL::intrusive_list_hook member;
+
+    explicit BaseItem(int v = 0)
+        : value(v) {}
+
+    friend bool operator<(const BaseItem& lhs, const BaseItem& rhs) { return lhs.value < rhs.value; }
+};
+
+using LruList     = TinySTL::intrusive_list<Item, &Item::lru>;
+using BucketList  = TinySTL::intrusive_list<Item, &Item::bucket>;
+using FreeList    = TinySTL::intrusive_forward_list<Item, &Item::free>;
+using BaseList    = TinySTL::intrusive_list<BaseItem>;
+using MemberList  = TinySTL::intrusive_list<BaseItem, &BaseItem::member>;
+using BaseForward = TinySTL::intrusive_forward_list<BaseItem>;
+
+template <typename List>
+std::vector<int> Values(const List& list) {
+    std::vector<int> values;
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        values.push_back(it->value);
+    }
+    return values;
+}
+
+class TestIntrusiveList : public testing::Test {
+protected:
+    // Declared before the lists, so that they outlive them.
+    std::vector<Item> m_items;
+
+protected:
+    virtual void SetUp() override {
+        for (int i = 0; i < 10; ++i) {
+            m_items.emplace_back(i);
+        }
+    }
+};
+
+TEST_F(TestIntrusiveList, Push) {
+    LruList list;
+    for (int i = 0; i < 5; ++i) {
+        list.push_back(m_items[i]);
+    }
+    list.push_front(m_items[9]);
+    EXPECT_EQ(Values(list), (std::vector<int>{ 9, 0, 1, 2, 3, 4 }));
+    EXPECT_EQ(list.size(), 6u);
+    EXPECT_EQ(&list.front(), &m_items[9]);
+    EXPECT_EQ(&list.back(), &m_items[4]);
+    EXPECT_TRUE(m_items[0].lru.is_linked());
+    EXPECT_FALSE(m_items[5].lru.is_linked());
+    // The object itself, no copy.
+    EXPECT_TRUE(LruList::iterator_to(m_items[2]) == ++++++list.begin());
+
+    list.insert(LruList::iterator_to(m_items[2]), m_items[7]);
+    EXPECT_EQ(Values(list), (std::vector<int>{ 9, 0, 1, 7, 2, 3, 4 }));
+}
+
+TEST_F(TestIntrusiveList, Erase) {
+    LruList list;
+    for (auto& item : m_items) {
+        list.push_back(item);
+    }
+    // O(1) from the object.
+    list.erase(m_items[4]);
+    EXPECT_FALSE(m_items[4].lru.is_linked());
+    auto it = list.erase(LruList::iterator_to(m_items[6]));
+    EXPECT_EQ(&*it, &m_items[7]);
+    list.pop_front();
+    list.pop_back();
+    EXPECT_EQ(Values(list), (std::vector<int>{ 1, 2, 3, 5, 7, 8 }));
+
+    list.erase(LruList::iterator_to(m_items[2]), LruList::iterator_to(m_items[7]));
+    EXPECT_EQ(Values(list), (std::vector<int>{ 1, 7, 8 }));
+    EXPECT_EQ(list.size(), 3u);
+    EXPECT_FALSE(m_items[5].lru.is_linked());
+
+    // An erased object can go back on a list.
+    list.push_front(m_items[4]);
+    list.remove_if([](const Item& item) { return item.value > 7; });
+    EXPECT_EQ(Values(list), (std::vector<int>{ 4, 1, 7 }));
+}
+
+TEST_F(TestIntrusiveList, Splice) {
+    LruList lhs;
+    LruList rhs;
+    for (int i = 0; i < 5; ++i) {
+        lhs.push_back(m_items[i]);
+        rhs.push_back(m_items[i + 5]);
+    }
+
+    // One object.
+    lhs.splice(lhs.begin(), rhs, LruList::iterator_to(m_items[7]));
+    EXPECT_EQ(Values(lhs), (std::vector<int>{ 7, 0, 1, 2, 3, 4 }));
+    EXPECT_EQ(Values(rhs), (std::vector<int>{ 5, 6, 8, 9 }));
+
+    // A range, counted and with its length given.
+    lhs.splice(lhs.end(), rhs, rhs.begin(), LruList::iterator_to(m_items[8]));
+    EXPECT_EQ(Values(lhs), (std::vector<int>{ 7, 0, 1, 2, 3, 4, 5, 6 }));
+    rhs.splice(rhs.begin(), lhs, lhs.begin(), LruList::iterator_to(m_items[1]), 2);
+    EXPECT_EQ(Values(rhs), (std::vector<int>{ 7, 0, 8, 9 }));
+    EXPECT_EQ(lhs.size(), 6u);
+    EXPECT_EQ(rhs.size(), 4u);
+
+    // Within one list.
+    lhs.splice(lhs.begin(), lhs, LruList::iterator_to(m_items[5]), lhs.end());
+    EXPECT_EQ(Values(lhs), (std::vector<int>{ 5, 6, 1, 2, 3, 4 }));
+    EXPECT_EQ(lhs.size(), 6u);
+
+    // Everything.
+    lhs.splice(LruList::iterator_to(m_items[2]), rhs);
+    EXPECT_EQ(Values(lhs), (std::vector<int>{ 5, 6, 1, 7, 0, 8, 9, 2, 3, 4 }));
+    EXPECT_EQ(lhs.size(), 10u);
+    EXPECT_TRUE(rhs.empty());
+
+    swap(lhs, rhs);
+    EXPECT_TRUE(lhs.empty());
+    EXPECT_EQ(rhs.size(), 10u);
+    LruList moved(std::move(rhs));
+    EXPECT_EQ(moved.size(), 10u);
+    EXPECT_TRUE(rhs.empty());
+}
+
+TEST_F(TestIntrusiveList, SortMergeReverse) {
+    LruList lhs;
+    LruList rhs;
+    int order[] = { 6, 2, 8, 0, 4 };
+    for (int i : order) {
+        lhs.push_back(m_items[i]);
+        rhs.push_front(m_items[i + 1]);
+    }
+    lhs.sort();
+    rhs.sort();
+    EXPECT_EQ(Values(lhs), (std::vector<int>{ 0, 2, 4, 6, 8 }));
+    lhs.merge(rhs);
+    EXPECT_EQ(Values(lhs), (std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+    EXPECT_EQ(lhs.size(), 10u);
+    EXPECT_TRUE(rhs.empty());
+    lhs.reverse();
+    EXPECT_EQ(Values(lhs), (std::vector<int>{ 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 }));
+}
+
+TEST_F(TestIntrusiveList, SeveralLists) {
+    LruList lru;
+    BucketList even;
+    BucketList odd;
+    FreeList free;
+    for (auto& item : m_items) {
+        lru.push_back(item);
+        (item.value % 2 == 0 ? even : odd).push_back(item);
+        free.push_front(item);
+    }
+    // Unlinking from one list leaves the others alone.
+    lru.erase(m_items[4]);
+    even.erase(m_items[6]);
+    free.erase(m_items[8]);
+    EXPECT_EQ(Values(lru), (std::vector<int>{ 0, 1, 2, 3, 5, 6, 7, 8, 9 }));
+    EXPECT_EQ(Values(even), (std::vector<int>{ 0, 2, 4, 8 }));
+    EXPECT_EQ(Values(odd), (std::vector<int>{ 1, 3, 5, 7, 9 }));
+    EXPECT_EQ(Values(free), (std::vector<int>{ 9, 7, 6, 5, 4, 3, 2, 1, 0 }));
+    EXPECT_TRUE(m_items[4].bucket.is_linked());
+    EXPECT_FALSE(m_items[4].lru.is_linked());
+}
+
+TEST_F(TestIntrusiveList, UnlinkedWithTheList) {
+    {
+        LruList list;
+        for (auto& item : m_items) {
+            list.push_back(item);
+        }
+        list.clear();
+        EXPECT_TRUE(list.empty());
+        for (auto& item : m_items) {
+            EXPECT_FALSE(item.lru.is_linked());
+            list.push_back(item);
+        }
+    }
+    // The list unlinks its objects when it goes away, they can join another one.
+    for (auto& item : m_items) {
+        EXPECT_FALSE(item.lru.is_linked());
+    }
+    LruList other;
+    other.push_back(m_items[3]);
+
+    // A copy of a linked object is not linked.
+    Item copy(m_items[3]);
+    EXPECT_TRUE(m_items[3].lru.is_linked());
+    EXPECT_FALSE(copy.lru.is_linked());
+    copy = m_items[3];
+    EXPECT_FALSE(copy.lru.is_linked());
+    EXPECT_EQ(other.size(), 1u);
+}
+
+TEST(TestIntrusiveListHook, BaseAndMemberHooks) {
+    std::vector<BaseItem> items;
+    for (int i = 0; i < 6; ++i) {
+        items.emplace_back(i);
+    }
+    BaseList by_base;
+    MemberList by_member;
+    BaseForward forward;
+    for (auto& item : items) {
+        by_base.push_front(item);
+        by_member.push_back(item);
+        forward.push_front(item);
+    }
+    EXPECT_EQ(Values(by_base), (std::vector<int>{ 5, 4, 3, 2, 1, 0 }));
+    EXPECT_EQ(Values(by_member), (std::vector<int>{ 0, 1, 2, 3, 4, 5 }));
+    EXPECT_EQ(Values(forward), (std::vector<int>{ 5, 4, 3, 2, 1, 0 }));
+
+    // The base hook is the object itself, the member hook sits inside it.
+    EXPECT_EQ(&*BaseList::iterator_to(items[2]), &items[2]);
+    EXPECT_EQ(&*MemberList::iterator_to(items[2]), &items[2]);
+    EXPECT_EQ(static_cast<TinySTL::intrusive_list_hook*>(&items[2]), BaseList::iterator_to(items[2]).m_inner);
+    EXPECT_EQ(&items[2].member, MemberList::iterator_to(items[2]).m_inner);
+
+    by_base.erase(items[2]);
+    by_base.sort();
+    forward.sort();
+    EXPECT_EQ(Values(by_base), (std::vector<int>{ 0, 1, 3, 4, 5 }));
+    EXPECT_EQ(Values(forward), (std::vector<int>{ 0, 1, 2, 3, 4, 5 }));
+    EXPECT_FALSE(static_cast<TinySTL::intrusive_list_hook&>(items[2]).is_linked());
+    EXPECT_TRUE(items[2].member.is_linked());
+    EXPECT_EQ(Values(by_member), (std::vector<int>{ 0, 1, 2, 3, 4, 5 }));
+}
+
+TEST_F(TestIntrusiveList, ForwardList) {
+    FreeList list;
+    for (int i = 4; i >= 0; --i) {
+        list.push_front(m_items[i]);
+    }
+    EXPECT_EQ(Values(list), (std::vector<int>{ 0, 1, 2, 3, 4 }));
+    EXPECT_EQ(list.size(), 5u);
+
+    list.insert_after(FreeList::iterator_to(m_items[1]), m_items[9]);
+    EXPECT_EQ(Values(list), (std::vector<int>{ 0, 1, 9, 2, 3, 4 }));
+    list.erase_after(FreeList::iterator_to(m_items[9]));
+    list.erase(m_items[0]);
+    list.pop_front();
+    EXPECT_EQ(Values(list), (std::vector<int>{ 9, 3, 4 }));
+    EXPECT_EQ(list.size(), 3u);
+    EXPECT_EQ(m_items[0].free.next, nullptr);
+
+    FreeList other;
+    for (int i = 8; i >= 5; --i) {
+        other.push_front(m_items[i]);
+    }
+    // One object, a range and everything.
+    list.splice_after(list.before_begin(), other, FreeList::iterator_to(m_items[6]));
+    EXPECT_EQ(Values(list), (std::vector<int>{ 7, 9, 3, 4 }));
+    list.splice_after(FreeList::iterator_to(m_items[4]), other, other.before_begin(), FreeList::iterator_to(m_items[6]));
+    EXPECT_EQ(Values(list), (std::vector<int>{ 7, 9, 3, 4, 5, 6 }));
+    EXPECT_EQ(Values(other), (std::vector<int>{ 8 }));
+    list.splice_after(list.before_begin(), other);
+    EXPECT_EQ(Values(list), (std::vector<int>{ 8, 7, 9, 3, 4, 5, 6 }));
+    EXPECT_EQ(list.size(), 7u);
+    EXPECT_TRUE(other.empty());
+
+    list.sort();
+    EXPECT_EQ(Values(list), (std::vector<int>{ 3, 4, 5, 6, 7, 8, 9 }));
+    other.push_front(m_items[2]);
+    other.push_front(m_items[0]);
+    list.merge(other);
+    EXPECT_EQ(Values(list), (std::vector<int>{ 0, 2, 3, 4, 5, 6, 7, 8, 9 }));
+    list.remove_if([](const Item& item) { return item.value % 3 == 0; });
+    list.reverse();
+    EXPECT_EQ(Values(list), (std::vector<int>{ 8, 7, 5, 4, 2 }));
+    EXPECT_EQ(list.size(), 5u);
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <stl_arena.hpp>
+#include <stl_forward_list.hpp>
+#include <stl_list.hpp>
+#include <vector>
+
+template <typename List>
+size_t CountElements(const List& list) {
+    size_t n = 0;
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        ++n;
+    }
+    return n;
+}
+
+template <typename List>
+std::vector<int> ToVector(const List& list) {
+    std::vector<int> v;
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        v.push_back(*it);
+    }
+    return v;
+}
+
+template <typename List>
+bool IsSorted(const List& list) {
+    std::vector<int> v = ToVector(list);
+    return std::is_sorted(v.begin(), v.end());
+}
+
+class TestList : public testing::Test {
+protected:
+    TinySTL::list<int> m_list1;
+    TinySTL::list<int> m_list2;
+
+protected:
+    virtual void SetUp() override {
+        for (int i = 0; i < 10; ++i) {
+            m_list1.push_back(i * 2);
+            m_list2.push_back(i * 2 + 1);
+        }
+    }
+};
+
+TEST_F(TestList, SizeAfterSplice) {
+    // Whole list.
+    m_list1.splice(m_list1.begin(), m_list2);
+    EXPECT_EQ(m_list1.size(), 20u);
+    EXPECT_EQ(m_list2.size(), 0u);
+
+    // One element.
+    m_list2.splice(m_list2.end(), m_list1, m_list1.begin());
+    EXPECT_EQ(m_list1.size(), 19u);
+    EXPECT_EQ(m_list2.size(), 1u);
+
+    // A range, counted and given.
+    auto first = m_list1.begin();
+    auto last  = first;
+    TinySTL::advance(last, 5);
+    m_list2.splice(m_list2.begin(), m_list1, first, last);
+    EXPECT_EQ(m_list1.size(), 14u);
+    EXPECT_EQ(m_list2.size(), 6u);
+
+    first = m_list1.begin();
+    last  = first;
+    TinySTL::advance(last, 4);
+    m_list2.splice(m_list2.end(), m_list1, first, last, 4);
+    EXPECT_EQ(m_list1.size(), 10u);
+    EXPECT_EQ(m_list2.size(), 10u);
+
+    // Inside the same list.
+    first = m_list1.begin();
+    ++first;
+    m_list1.splice(m_list1.end(), m_list1, first, m_list1.end());
+    EXPECT_EQ(m_list1.size(), 10u);
+
+    EXPECT_EQ(CountElements(m_list1), m_list1.size());
+    EXPECT_EQ(CountElements(m_list2), m_list2.size());
+}
+
+TEST_F(TestList, SizeAfterMerge) {
+    m_list1.merge(m_list2);
+    EXPECT_EQ(m_list1.size(), 20u);
+    EXPECT_TRUE(m_list2.empty());
+    EXPECT_EQ(CountElements(m_list1), 20u);
+    EXPECT_TRUE(IsSorted(m_list1));
+
+    m_list1.merge(m_list1);
+    EXPECT_EQ(m_list1.size(), 20u);
+}
+
+TEST(TestListSort, SortIsStable) {
+    // Sort by the tens only, the ones tell the original order.
+    struct TensLess {
+        bool operator()(int a, int b) const { return a / 10 < b / 10; }
+    };
+    std::mt19937 gen(1);
+    std::vector<int> data;
+    for (int i = 0; i < 1000; ++i) {
+        data.push_back((int)(gen() % 100) * 10 + i % 10);
+    }
+    TinySTL::list<int> list(data.data(), data.data() + data.size());
+    list.sort(TensLess());
+    std::stable_sort(data.begin(), data.end(), TensLess());
+    EXPECT_EQ(ToVector(list), data);
+}
+
+TEST(TestListSort, UnstableSortWithArena) {
+    TinySTL::monotonic_arena arena;
+    TinySTL::list<int, TinySTL::arena_alloc> list((TinySTL::arena_alloc(arena)));
+    TinySTL::forward_list<int, TinySTL::arena_alloc> forward((TinySTL::arena_alloc(arena)));
+
+    // Long enough to sort by the array.
+    std::mt19937 gen(2);
+    std::vector<int> data;
+    for (int i = 0; i < 20000; ++i) {
+        data.push_back((int)(gen() % 5000));
+        list.push_back(data.back());
+        forward.push_front(data.back());
+    }
+    std::sort(data.begin(), data.end());
+
+    list.unstable_sort();
+    EXPECT_EQ(ToVector(list), data);
+    EXPECT_EQ(list.size(), data.size());
+
+    forward.unstable_sort();
+    EXPECT_EQ(ToVector(forward), data);
+    EXPECT_EQ(forward.size(), data.size());
+
+    // Short lists merge sort.
+    TinySTL::list<int, TinySTL::arena_alloc> shorter((TinySTL::arena_alloc(arena)));
+    for (int i = 0; i < 100; ++i) {
+        shorter.push_back(100 - i);
+    }
+    shorter.unstable_sort();
+    EXPECT_TRUE(IsSorted(shorter));
+}
+
+class TestForwardList : public testing::Test {
+protected:
+    TinySTL::forward_list<int> m_list1;
+    TinySTL::forward_list<int> m_list2;
+
+protected:
+    virtual void SetUp() override {
+        for (int i = 9; i >= 0; --i) {
+            m_list1.push_front(i * 2);
+            m_list2.push_front(i * 2 + 1);
+        }
+    }
+};
+
+TEST_F(TestForwardList, SizeAfterSplice) {
+    // Whole list.
+    m_list1.splice(m_list1.begin(), m_list2);
+    EXPECT_EQ(m_list1.size(), 20u);
+    EXPECT_EQ(m_list2.size(), 0u);
+
+    // One element, the one after the first.
+    m_list2.push_front(-1);
+    m_list2.splice_after(m_list2.begin(), m_list1, m_list1.begin());
+    EXPECT_EQ(m_list1.size(), 19u);
+    EXPECT_EQ(m_list2.size(), 2u);
+
+    // A range after the first, counted and given.
+    auto before_last = m_list1.begin();
+    TinySTL::advance(before_last, 5);
+    m_list2.splice_after(m_list2.begin(), m_list1, m_list1.begin(), before_last);
+    EXPECT_EQ(m_list1.size(), 14u);
+    EXPECT_EQ(m_list2.size(), 7u);
+
+    before_last = m_list1.begin();
+    TinySTL::advance(before_last, 4);
+    m_list2.splice_after(m_list2.begin(), m_list1, m_list1.begin(), before_last, 4);
+    EXPECT_EQ(m_list1.size(), 10u);
+    EXPECT_EQ(m_list2.size(), 11u);
+
+    EXPECT_EQ(CountElements(m_list1), m_list1.size());
+    EXPECT_EQ(CountElements(m_list2), m_list2.size());
+}
+
+TEST_F(TestForwardList, SizeAfterMerge) {
+    m_list1.merge(m_list2);
+    EXPECT_EQ(m_list1.size(), 20u);
+    EXPECT_TRUE(m_list2.empty());
+    EXPECT_EQ(CountElements(m_list1), 20u);
+    EXPECT_TRUE(IsSorted(m_list1));
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <random>
+#include <stl_mmap_vector.hpp>
+#include <string>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+class TestMmapVector : public testing::Test {
+protected:
+    std::string m_path;
+
+protected:
+    virtual void SetUp() override {
+        char path[] = "/tmp/test_stl_mmap_vector_XXXXXX";
+        int fd      = mkstemp(path);
+        ASSERT_NE(fd, -1);
+        ::close(fd);
+        m_path = path;
+    }
+
+    virtual void TearDown() override {
+        std::remove(m_path.c_str());
+    }
+
+    off_t FileBytes() const {
+        struct stat st;
+        return stat(m_path.c_str(), &st) == 0 ? st.st_size : -1;
+    }
+
+    void WriteBytes(size_t n) const {
+        FILE* file = std::fopen(m_path.c_str(), "wb");
+        for (size_t i = 0; i < n; ++i) {
+            std::fputc((int)i, file);
+        }
+        std::fclose(file);
+    }
+};
+
+TEST_F(TestMmapVector, Reopen) {
+    {
+        TinySTL::mmap_vector<int> ints(m_path.c_str());
+        EXPECT_TRUE(ints.empty());
+        for (int i = 0; i < 10000; ++i) {
+            ints.push_back(i);
+        }
+        ints.erase(ints.begin() + 100, ints.begin() + 200);
+        ints.resize(9850);
+    }
+    // Cut to the elements on close.
+    EXPECT_EQ(FileBytes(), (off_t)(9850 * sizeof(int)));
+
+    TinySTL::mmap_vector<int> ints(m_path.c_str());
+    ASSERT_EQ(ints.size(), 9850u);
+    for (int i = 0; i < 9850; ++i) {
+        EXPECT_EQ(ints[i], i < 100 ? i : i + 100) << "at " << i;
+    }
+
+    TinySTL::mmap_vector<int> truncated(m_path.c_str(), true);
+    EXPECT_TRUE(truncated.empty());
+}
+
+TEST_F(TestMmapVector, Growth) {
+    TinySTL::mmap_vector<long> longs(m_path.c_str());
+    size_t remaps    = 0;
+    size_t capacity  = longs.capacity();
+    const size_t len = 1000000;
+    for (size_t i = 0; i < len; ++i) {
+        longs.push_back((long)i);
+        if (longs.capacity() != capacity) {
+            // Whole pages.
+            EXPECT_EQ(longs.capacity() * sizeof(long) % sysconf(_SC_PAGESIZE), 0u);
+            capacity = longs.capacity();
+            ++remaps;
+        }
+    }
+    // Geometric, so the mapping grows a few times for a million elements, not once per page.
+    EXPECT_GT(remaps, 3u);
+    EXPECT_LT(remaps, 40u);
+
+    long more[] = { -1, -2, -3 };
+    longs.append(more, more + 3);
+    ASSERT_EQ(longs.size(), len + 3);
+    for (size_t i = 0; i < len; ++i) {
+        ASSERT_EQ(longs[i], (long)i);
+    }
+    EXPECT_EQ(longs.back(), -3);
+}
+
+TEST_F(TestMmapVector, ShrinkToFit) {
+    TinySTL::mmap_vector<int> ints(m_path.c_str());
+    ints.reserve(1000000);
+    EXPECT_GE(ints.capacity(), 1000000u);
+    EXPECT_GE(FileBytes(), (off_t)(1000000 * sizeof(int)));
+    for (int i = 0; i < 1000; ++i) {
+        ints.push_back(i);
+    }
+
+    ints.shrink_to_fit();
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    EXPECT_EQ(ints.capacity(), (1000 * sizeof(int) + page - 1) / page * page / sizeof(int));
+    EXPECT_EQ(FileBytes(), (off_t)(ints.capacity() * sizeof(int)));
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(ints[i], i);
+    }
+
+    ints.clear();
+    ints.shrink_to_fit();
+    EXPECT_EQ(ints.capacity(), 0u);
+    ints.push_back(7);
+    EXPECT_EQ(ints.front(), 7);
+}
+
+TEST_F(TestMmapVector, SortInPlace) {
+    std::mt19937 gen(1);
+    {
+        TinySTL::mmap_vector<unsigned> values(m_path.c_str());
+        for (int i = 0; i < 100000; ++i) {
+            values.push_back(gen() % 1000000);
+        }
+        TinySTL::sort(values.begin(), values.end());
+        values.sync();
+    }
+
+    TinySTL::mmap_vector<unsigned> values(m_path.c_str());
+    ASSERT_EQ(values.size(), 100000u);
+    for (size_t i = 1; i < values.size(); ++i) {
+        ASSERT_LE(values[i - 1], values[i]) << "at " << i;
+    }
+    for (int i = 0; i < 100; ++i) {
+        unsigned key = gen() % 1000000;
+        auto it      = TinySTL::lower_bound(values.begin(), values.end(), key);
+        EXPECT_TRUE(it == values.end() || *it >= key);
+        EXPECT_TRUE(it == values.begin() || *(it - 1) < key);
+    }
+    auto it = TinySTL::lower_bound(values.begin(), values.end(), values[500]);
+    EXPECT_EQ(*it, values[500]);
+}
+
+TEST_F(TestMmapVector, PartialElement) {
+    // Not a multiple of sizeof(int), opening it would cut the last 3 bytes on close.
+    WriteBytes(4 * 5 + 3);
+    try {
+        TinySTL::mmap_vector<int> ints(m_path.c_str());
+        FAIL() << "opened a file with a partial element";
+    }
+    catch (const std::system_error& e) {
+        EXPECT_EQ(e.code().value(), EINVAL);
+    }
+    EXPECT_EQ(FileBytes(), 4 * 5 + 3);
+
+    // A size below one page keeps its bytes.
+    WriteBytes(4 * 5);
+    {
+        TinySTL::mmap_vector<int> ints(m_path.c_str());
+        EXPECT_EQ(ints.size(), 5u);
+    }
+    EXPECT_EQ(FileBytes(), 4 * 5);
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <stl_list.hpp>
+#include <stl_map.hpp>
+#include <stl_numa.hpp>
+#include <stl_vector.hpp>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+using Alloc = TinySTL::numa_alloc;
+
+TEST(TestNumaAlloc, RoundTrip) {
+    EXPECT_GE(Alloc::current_node(), 0);
+    EXPECT_LT(Alloc::current_node(), 8);
+
+    std::vector<std::pair<char*, size_t>> blocks;
+    for (size_t n = 1; n <= 2048; n += 7) {
+        char* p = (char*)Alloc::allocate(n);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ((size_t)p % 8, 0u);
+        memset(p, (int)(n & 0xff), n);
+        blocks.push_back({ p, n });
+    }
+    for (auto& block : blocks) {
+        for (size_t i = 0; i < block.second; ++i) {
+            ASSERT_EQ((unsigned char)block.first[i], (unsigned char)(block.second & 0xff));
+        }
+        Alloc::deallocate(block.first, block.second);
+    }
+}
+
+TEST(TestNumaAlloc, Reallocate) {
+    int* p = (int*)Alloc::allocate(16 * sizeof(int));
+    for (int i = 0; i < 16; ++i) {
+        p[i] = i;
+    }
+    p = (int*)Alloc::reallocate(p, 16 * sizeof(int), 1000 * sizeof(int));
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(p[i], i);
+    }
+    Alloc::deallocate(p, 1000 * sizeof(int));
+}
+
+TEST(TestNumaAlloc, DeallocateChain) {
+    TinySTL::__node_chain<void*> chain;
+    for (int i = 0; i < 1000; ++i) {
+        chain.push((void**)Alloc::allocate(24));
+    }
+    Alloc::deallocate_chain(chain.head, chain.tail, chain.count, 24);
+    // The blocks are back in the pool and are handed out again.
+    void* p = Alloc::allocate(24);
+    EXPECT_NE(p, nullptr);
+    Alloc::deallocate(p, 24);
+}
+
+TEST(TestNumaAlloc, Threads) {
+    // Every thread frees the blocks of the next one, so that objects go back across threads and pools.
+    const int threads = 4;
+    const int blocks  = 20000;
+    std::vector<std::vector<int*>> allocated(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&allocated, t] {
+            for (int i = 0; i < blocks; ++i) {
+                int* p = (int*)Alloc::allocate(sizeof(int) * (1 + i % 16));
+                *p     = t * blocks + i;
+                allocated[t].push_back(p);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&allocated, t] {
+            const std::vector<int*>& mine = allocated[(t + 1) % threads];
+            for (int i = 0; i < blocks; ++i) {
+                EXPECT_EQ(*mine[i], (t + 1) % threads * blocks + i);
+                Alloc::deallocate(mine[i], sizeof(int) * (1 + i % 16));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    Alloc::trim();
+}
+
+TEST(TestNumaAlloc, Containers) {
+    TinySTL::vector<int, Alloc> ints;
+    TinySTL::list<int, Alloc> list;
+    TinySTL::map<int, int, TinySTL::less<int>, Alloc> map;
+    for (int i = 0; i < 10000; ++i) {
+        ints.push_back(i);
+        list.push_back(i);
+        map.insert(TinySTL::pair<const int, int>(i, -i));
+    }
+    EXPECT_EQ(ints.size(), 10000u);
+    EXPECT_EQ(list.size(), 10000u);
+    EXPECT_EQ(map.size(), 10000u);
+    EXPECT_EQ(ints[1234], 1234);
+    EXPECT_EQ(map.find(1234)->second, -1234);
+    list.clear();
+    map.clear();
+}
+
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+// The same policy with and without libnuma, preferred so that a full node spills to the others.
+TEST(TestNumaAlloc, PreferredPolicy) {
+    #ifdef TINYSTL_USE_LIBNUMA
+    if (numa_available() == -1) {
+        GTEST_SKIP() << "no NUMA support";
+    }
+    #endif
+    void* p            = Alloc::allocate(64);
+    int mode           = -1;
+    unsigned long mask = 0;
+    // MPOL_F_ADDR, the policy of the pages at `p`.
+    if (syscall(SYS_get_mempolicy, &mode, &mask, sizeof(mask) * 8, p, 2) != 0) {
+        Alloc::deallocate(p, 64);
+        GTEST_SKIP() << "get_mempolicy is not available";
+    }
+    // MPOL_PREFERRED on one node.
+    EXPECT_EQ(mode, 1);
+    EXPECT_NE(mask, 0u);
+    EXPECT_EQ(mask & (mask - 1), 0u);
+    Alloc::deallocate(p, 64);
+}
+#endif
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <set>
+#include <stl_small_vector.hpp>
+#include <string>
+#include <vector>
+
+class TestSmallVector : public testing::Test {
+protected:
+    TinySTL::small_vector<std::string, 8> m_strings;
+    std::vector<std::string> m_expected;
+
+protected:
+    virtual void SetUp() override {
+        // Long enough to live on the heap, so that a self-moved string is emptied.
+        for (int i = 0; i < 50; ++i) {
+            m_strings.push_back("string number " + std::to_string(i) + " of the small vector");
+            m_expected.push_back(m_strings.back());
+        }
+    }
+
+    void ExpectEqual() const {
+        ASSERT_EQ(m_strings.size(), m_expected.size());
+        for (size_t i = 0; i < m_expected.size(); ++i) {
+            EXPECT_EQ(m_strings[i], m_expected[i]) << "at " << i;
+        }
+    }
+};
+
+TEST_F(TestSmallVector, EraseEmptyRange) {
+    EXPECT_EQ(m_strings.erase(m_strings.begin() + 3, m_strings.begin() + 3), m_strings.begin() + 3);
+    m_strings.erase(m_strings.begin(), m_strings.begin());
+    m_strings.erase(m_strings.end(), m_strings.end());
+    ExpectEqual();
+}
+
+TEST_F(TestSmallVector, Erase) {
+    m_strings.erase(m_strings.begin() + 5, m_strings.begin() + 15);
+    m_expected.erase(m_expected.begin() + 5, m_expected.begin() + 15);
+    ExpectEqual();
+
+    m_strings.erase(m_strings.begin());
+    m_expected.erase(m_expected.begin());
+    ExpectEqual();
+}
+
+TEST_F(TestSmallVector, Insert) {
+    m_strings.insert(m_strings.begin() + 3, std::string("inserted"));
+    m_expected.insert(m_expected.begin() + 3, std::string("inserted"));
+    ExpectEqual();
+
+    m_strings.insert(m_strings.begin() + 20, 30, std::string("filled"));
+    m_expected.insert(m_expected.begin() + 20, 30, std::string("filled"));
+    ExpectEqual();
+
+    std::string data[] = { "a", "b", "c" };
+    m_strings.insert(m_strings.end() - 2, std::begin(data), std::end(data));
+    m_expected.insert(m_expected.end() - 2, std::begin(data), std::end(data));
+    ExpectEqual();
+}
+
+TEST_F(TestSmallVector, Inline) {
+    TinySTL::small_vector<std::string, 8> small;
+    for (int i = 0; i < 8; ++i) {
+        small.push_back(m_expected[i]);
+    }
+    EXPECT_TRUE(small.is_inline());
+    small.erase(small.begin() + 2, small.begin() + 2);
+    small.insert(small.begin() + 1, std::string("spilled"));
+    EXPECT_FALSE(small.is_inline());
+
+    small.erase(small.begin() + 1);
+    small.shrink_to_fit();
+    EXPECT_TRUE(small.is_inline());
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(small[i], m_expected[i]);
+    }
+
+    swap(small, m_strings);
+    EXPECT_EQ(small.size(), 50u);
+    EXPECT_EQ(m_strings.size(), 8u);
+    EXPECT_TRUE(m_strings.is_inline());
+}
+
+// Stateful allocator that checks every block goes back to the allocator it came from.
+class OwnerAlloc {
+private:
+    std::set<void*>* m_blocks;
+
+public:
+    explicit OwnerAlloc(std::set<void*>& blocks)
+        : m_blocks(&blocks) {}
+
+    void* allocate(size_t n) const {
+        void* ptr = malloc(n);
+        m_blocks->insert(ptr);
+        return ptr;
+    }
+
+    void deallocate(void* ptr, size_t) const {
+        EXPECT_EQ(m_blocks->erase(ptr), 1u) << "freed through another allocator";
+        free(ptr);
+    }
+
+    void* reallocate(void* ptr, size_t, size_t new_size) const {
+        EXPECT_EQ(m_blocks->erase(ptr), 1u) << "reallocated through another allocator";
+        ptr = realloc(ptr, new_size);
+        m_blocks->insert(ptr);
+        return ptr;
+    }
+
+    const std::set<void*>* blocks() const { return m_blocks; }
+};
+
+class TestSmallVectorAlloc : public testing::Test {
+protected:
+    std::set<void*> m_lhs_blocks;
+    std::set<void*> m_rhs_blocks;
+
+protected:
+    virtual void TearDown() override {
+        EXPECT_TRUE(m_lhs_blocks.empty());
+        EXPECT_TRUE(m_rhs_blocks.empty());
+    }
+};
+
+TEST_F(TestSmallVectorAlloc, MoveAssign) {
+    // int is trivially relocatable and grows by reallocate, std::string by allocate and deallocate.
+    TinySTL::small_vector<int, 4, OwnerAlloc> lhs{ OwnerAlloc(m_lhs_blocks) };
+    TinySTL::small_vector<int, 4, OwnerAlloc> rhs{ OwnerAlloc(m_rhs_blocks) };
+    for (int i = 0; i < 100; ++i) {
+        lhs.push_back(-i);
+        rhs.push_back(i);
+    }
+
+    // The space of rhs comes with its allocator.
+    lhs = std::move(rhs);
+    EXPECT_TRUE(m_lhs_blocks.empty());
+    EXPECT_EQ(lhs.get_allocator().blocks(), &m_rhs_blocks);
+    EXPECT_TRUE(rhs.empty());
+    EXPECT_TRUE(rhs.is_inline());
+    for (int i = 100; i < 1000; ++i) {
+        lhs.push_back(i);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(lhs[i], i);
+    }
+
+    // Moving inlined elements.
+    rhs.push_back(7);
+    lhs = std::move(rhs);
+    EXPECT_TRUE(lhs.is_inline());
+    EXPECT_EQ(lhs.size(), 1u);
+    EXPECT_EQ(lhs[0], 7);
+
+    TinySTL::small_vector<std::string, 4, OwnerAlloc> strings{ OwnerAlloc(m_lhs_blocks) };
+    TinySTL::small_vector<std::string, 4, OwnerAlloc> others{ OwnerAlloc(m_rhs_blocks) };
+    for (int i = 0; i < 50; ++i) {
+        strings.push_back("a string long enough to live on the heap " + std::to_string(i));
+        others.push_back(std::to_string(i));
+    }
+    strings = std::move(others);
+    strings.resize(200, "more");
+    EXPECT_EQ(strings[49], "49");
+    EXPECT_EQ(strings[199], "more");
+}
+
+TEST_F(TestSmallVectorAlloc, SwapInlineAndHeap) {
+    TinySTL::small_vector<int, 4, OwnerAlloc> small{ OwnerAlloc(m_lhs_blocks) };
+    TinySTL::small_vector<int, 4, OwnerAlloc> large{ OwnerAlloc(m_rhs_blocks) };
+    small.push_back(1);
+    small.push_back(2);
+    for (int i = 0; i < 100; ++i) {
+        large.push_back(i);
+    }
+
+    swap(small, large);
+    EXPECT_FALSE(small.is_inline());
+    EXPECT_TRUE(large.is_inline());
+    EXPECT_EQ(small.size(), 100u);
+    EXPECT_EQ(large.size(), 2u);
+    EXPECT_EQ(small.get_allocator().blocks(), &m_rhs_blocks);
+    EXPECT_EQ(large.get_allocator().blocks(), &m_lhs_blocks);
+
+    // Both grow and free through the allocators they now hold.
+    for (int i = 0; i < 100; ++i) {
+        small.push_back(i);
+        large.push_back(i);
+    }
+    EXPECT_FALSE(m_lhs_blocks.empty());
+
+    // Both allocated.
+    swap(small, large);
+    EXPECT_EQ(small.size(), 102u);
+    EXPECT_EQ(large.size(), 200u);
+    EXPECT_EQ(small.get_allocator().blocks(), &m_lhs_blocks);
+
+    // Both inline.
+    TinySTL::small_vector<int, 4, OwnerAlloc> one{ OwnerAlloc(m_lhs_blocks) };
+    TinySTL::small_vector<int, 4, OwnerAlloc> two{ OwnerAlloc(m_rhs_blocks) };
+    one.push_back(1);
+    two.push_back(2);
+    two.push_back(2);
+    swap(one, two);
+    EXPECT_EQ(one.size(), 2u);
+    EXPECT_EQ(two.size(), 1u);
+    EXPECT_EQ(one.get_allocator().blocks(), &m_rhs_blocks);
+}
+
+TEST_F(TestSmallVectorAlloc, ShrinkToFit) {
+    TinySTL::small_vector<std::string, 4, OwnerAlloc> strings{ OwnerAlloc(m_lhs_blocks) };
+    for (int i = 0; i < 100; ++i) {
+        strings.push_back(std::to_string(i));
+    }
+
+    // Back inline, the space is given back.
+    strings.erase(strings.begin() + 3, strings.end());
+    strings.shrink_to_fit();
+    EXPECT_TRUE(strings.is_inline());
+    EXPECT_TRUE(m_lhs_blocks.empty());
+    EXPECT_EQ(strings.size(), 3u);
+    EXPECT_EQ(strings[2], "2");
+
+    // Still too many to be inline, shrunk to the size.
+    for (int i = 3; i < 100; ++i) {
+        strings.push_back(std::to_string(i));
+    }
+    strings.resize(10);
+    strings.shrink_to_fit();
+    EXPECT_FALSE(strings.is_inline());
+    EXPECT_EQ(strings.capacity(), 10u);
+    EXPECT_EQ(m_lhs_blocks.size(), 1u);
+    EXPECT_EQ(strings[9], "9");
+
+    // Exactly the inline capacity.
+    strings.resize(4);
+    strings.shrink_to_fit();
+    EXPECT_TRUE(strings.is_inline());
+    EXPECT_EQ(strings[3], "3");
+
+    // Moving from a shrunk vector.
+    TinySTL::small_vector<std::string, 4, OwnerAlloc> moved(std::move(strings));
+    EXPECT_EQ(moved.size(), 4u);
+    EXPECT_TRUE(strings.empty());
+}
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <set>
+#include <stl_map.hpp>
+#include <stl_multimap.hpp>
+#include <stl_multiset.hpp>
+#include <stl_set.hpp>
+#include <string>
+
+template <typename Tree, typename Expected>
+void ExpectSameKeys(const Tree& tree, const Expected& expected) {
+    ASSERT_EQ(tree.size(), expected.size());
+    auto it = tree.begin();
+    for (auto&& key : expected) {
+        ASSERT_TRUE(it != tree.end());
+        EXPECT_EQ(*it, key);
+        ++it;
+    }
+    EXPECT_TRUE(it == tree.end());
+}
+
+template <typename Map, typename Expected>
+void ExpectSameEntries(const Map& map, const Expected& expected) {
+    ASSERT_EQ(map.size(), expected.size());
+    auto it = map.begin();
+    for (auto&& entry : expected) {
+        ASSERT_TRUE(it != map.end());
+        EXPECT_EQ(it->first, entry.first);
+        EXPECT_EQ(it->second, entry.second);
+        ++it;
+    }
+}
+
+// What `merge` into a container of unique keys does: move over the entries whose keys are not there yet.
+template <typename Unique, typename Source>
+void MergeUnique(Unique& target, Source& source) {
+    for (auto it = source.begin(); it != source.end();) {
+        if (target.insert(*it).second) {
+            it = source.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+// What `merge` into a container of equal keys does: move over everything.
+template <typename Equal, typename Source>
+void MergeEqual(Equal& target, Source& source) {
+    target.insert(source.begin(), source.end());
+    source.clear();
+}
+
+class TestMapNodeHandle : public testing::Test {
+protected:
+    using map_type = TinySTL::map<int, std::string>;
+    using value    = TinySTL::pair<const int, std::string>;
+
+    map_type m_map;
+    std::map<int, std::string> m_expected;
+
+protected:
+    virtual void SetUp() override {
+        for (int i = 0; i < 100; ++i) {
+            std::string s = "value number " + std::to_string(i) + " of the map";
+            m_map.insert(value(i, s));
+            m_expected.emplace(i, s);
+        }
+    }
+};
+
+TEST_F(TestMapNodeHandle, ExtractAndReinsert) {
+    map_type::node_type node = m_map.extract(5);
+    ASSERT_FALSE(node.empty());
+    EXPECT_EQ(node.key(), 5);
+    EXPECT_EQ(m_map.size(), 99u);
+    EXPECT_TRUE(m_map.find(5) == m_map.end());
+
+    // Re-key without reallocating.
+    node.key() = 500;
+    node.mapped() += " moved";
+    auto result = m_map.insert(std::move(node));
+    EXPECT_TRUE(result.second);
+    EXPECT_TRUE(node.empty());
+    EXPECT_EQ(result.first->first, 500);
+
+    m_expected[500] = m_expected[5] + " moved";
+    m_expected.erase(5);
+    ExpectSameEntries(m_map, m_expected);
+}
+
+TEST_F(TestMapNodeHandle, FailedInsertKeepsNode) {
+    map_type::node_type node = m_map.extract(m_map.find(10));
+    node.key()               = 11;
+    auto result              = m_map.insert(std::move(node));
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ(result.first->first, 11);
+    // The node is still owned by the handle.
+    ASSERT_FALSE(node.empty());
+    EXPECT_EQ(node.key(), 11);
+    EXPECT_EQ(node.mapped(), m_expected[10]);
+    EXPECT_EQ(m_map.size(), 99u);
+
+    // Give it another key and it goes in.
+    node.key() = 1000;
+    EXPECT_TRUE(m_map.insert(std::move(node)).second);
+    EXPECT_EQ(m_map.size(), 100u);
+}
+
+TEST_F(TestMapNodeHandle, ExtractMissing) {
+    EXPECT_TRUE(m_map.extract(1234).empty());
+    // The extracted node is freed with its handle.
+    EXPECT_TRUE(static_cast<bool>(m_map.extract(99)));
+    map_type::node_type empty;
+    auto result = m_map.insert(std::move(empty));
+    EXPECT_FALSE(result.second);
+    EXPECT_TRUE(result.first == m_map.end());
+    EXPECT_EQ(m_map.size(), 99u);
+}
+
+TEST_F(TestMapNodeHandle, MergeWithMultimap) {
+    TinySTL::multimap<int, std::string> multi;
+    std::multimap<int, std::string> expected_multi;
+    for (int i = 0; i < 60; ++i) {
+        multi.insert(value(i * 3, "a"));
+        multi.insert(value(i * 3, "b"));
+        expected_multi.emplace(i * 3, "a");
+        expected_multi.emplace(i * 3, "b");
+    }
+
+    m_map.merge(multi);
+    MergeUnique(m_expected, expected_multi);
+    ExpectSameEntries(m_map, m_expected);
+    ExpectSameEntries(multi, expected_multi);
+
+    multi.merge(m_map);
+    MergeEqual(expected_multi, m_expected);
+    EXPECT_TRUE(m_map.empty());
+    ExpectSameEntries(multi, expected_multi);
+}
+
+TEST(TestSetNodeHandle, ExtractAndMerge) {
+    std::mt19937 gen(1);
+    TinySTL::set<int> set;
+    TinySTL::multiset<int> multi;
+    std::set<int> expected_set;
+    std::multiset<int> expected_multi;
+    for (int i = 0; i < 1000; ++i) {
+        int a = (int)(gen() % 300);
+        int b = (int)(gen() % 400);
+        set.insert(a);
+        expected_set.insert(a);
+        multi.insert(b);
+        expected_multi.insert(b);
+    }
+
+    auto node = set.extract(set.begin());
+    node.value() = 1000;
+    EXPECT_TRUE(set.insert(std::move(node)).second);
+    expected_set.erase(expected_set.begin());
+    expected_set.insert(1000);
+
+    // A duplicate stays in the handle.
+    auto dup = set.extract(1000);
+    set.insert(999);
+    expected_set.insert(999);
+    dup.value() = 999;
+    EXPECT_FALSE(set.insert(std::move(dup)).second);
+    EXPECT_FALSE(dup.empty());
+    EXPECT_EQ(dup.value(), 999);
+    expected_set.erase(1000);
+    ExpectSameKeys(set, expected_set);
+
+    multi.insert(multi.extract(7));
+    ExpectSameKeys(multi, expected_multi);
+
+    set.merge(multi);
+    MergeUnique(expected_set, expected_multi);
+    ExpectSameKeys(set, expected_set);
+    ExpectSameKeys(multi, expected_multi);
+
+    multi.merge(set);
+    MergeEqual(expected_multi, expected_set);
+    EXPECT_TRUE(set.empty());
+    ExpectSameKeys(multi, expected_multi);
+
+    // Merging into itself changes nothing.
+    multi.merge(multi);
+    ExpectSameKeys(multi, expected_multi);
+}
+
+TEST(TestSetNodeHandle, MergeSets) {
+    TinySTL::set<int> a;
+    TinySTL::set<int> b;
+    for (int i = 0; i < 100; ++i) {
+        a.insert(i * 2);
+        b.insert(i * 3);
+    }
+    a.merge(b);
+    // The multiples of 6 up to 198 were in both, they stay in `b`.
+    EXPECT_EQ(a.size(), 166u);
+    EXPECT_EQ(b.size(), 34u);
+    for (auto it = b.begin(); it != b.end(); ++it) {
+        EXPECT_EQ(*it % 6, 0);
+    }
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <list>
+#include <random>
+#include <stl_arena.hpp>
+#include <stl_numeric.hpp>
+#include <stl_unrolled_list.hpp>
+#include <string>
+
+template <typename List, typename Expected>
+void ExpectSameElements(const List& list, const Expected& expected) {
+    ASSERT_EQ(list.size(), expected.size());
+    auto it = list.begin();
+    for (auto&& value : expected) {
+        ASSERT_TRUE(it != list.end());
+        EXPECT_EQ(*it, value);
+        ++it;
+    }
+    EXPECT_TRUE(it == list.end());
+}
+
+class TestUnrolledList : public testing::Test {
+protected:
+    // Small nodes, so that they are split and merged often.
+    TinySTL::unrolled_list<std::string, TinySTL::alloc, 4> m_strings;
+    std::list<std::string> m_expected;
+
+protected:
+    virtual void SetUp() override {
+        for (int i = 0; i < 50; ++i) {
+            m_strings.push_back("string number " + std::to_string(i) + " of the unrolled list");
+            m_expected.push_back(m_strings.back());
+        }
+    }
+};
+
+TEST_F(TestUnrolledList, PushPop) {
+    ExpectSameElements(m_strings, m_expected);
+
+    m_strings.push_front("front");
+    m_expected.push_front("front");
+    m_strings.pop_back();
+    m_expected.pop_back();
+    m_strings.pop_front();
+    m_expected.pop_front();
+    ExpectSameElements(m_strings, m_expected);
+    EXPECT_EQ(m_strings.front(), m_expected.front());
+    EXPECT_EQ(m_strings.back(), m_expected.back());
+}
+
+TEST_F(TestUnrolledList, InsertErase) {
+    std::mt19937 gen(1);
+    for (int i = 0; i < 2000; ++i) {
+        size_t index = gen() % (m_expected.size() + 1);
+        auto it      = m_strings.begin();
+        auto expect  = m_expected.begin();
+        TinySTL::advance(it, index);
+        std::advance(expect, index);
+        if (gen() % 2 == 0 || m_expected.empty()) {
+            it = m_strings.insert(it, std::to_string(i));
+            m_expected.insert(expect, std::to_string(i));
+            EXPECT_EQ(*it, std::to_string(i));
+        }
+        else if (index < m_expected.size()) {
+            it = m_strings.erase(it);
+            expect = m_expected.erase(expect);
+            if (expect != m_expected.end()) {
+                EXPECT_EQ(*it, *expect);
+            }
+        }
+    }
+    ExpectSameElements(m_strings, m_expected);
+
+    auto first = m_strings.begin();
+    auto last  = first;
+    TinySTL::advance(last, 10);
+    m_strings.erase(first, last);
+    auto expect_last = m_expected.begin();
+    std::advance(expect_last, 10);
+    m_expected.erase(m_expected.begin(), expect_last);
+    ExpectSameElements(m_strings, m_expected);
+}
+
+TEST_F(TestUnrolledList, CopyAndClear) {
+    TinySTL::unrolled_list<std::string, TinySTL::alloc, 4> copied(m_strings);
+    EXPECT_TRUE(copied == m_strings);
+
+    m_strings.clear();
+    EXPECT_TRUE(m_strings.empty());
+    EXPECT_TRUE(m_strings.begin() == m_strings.end());
+
+    m_strings = copied;
+    ExpectSameElements(m_strings, m_expected);
+
+    swap(m_strings, copied);
+    ExpectSameElements(copied, m_expected);
+}
+
+TEST(TestUnrolledListSegmented, Algorithms) {
+    // 4 ints per node, so that the algorithms run across many nodes.
+    TinySTL::unrolled_list<int, TinySTL::alloc, 4> ints;
+    for (int i = 0; i < 100; ++i) {
+        ints.push_back(i);
+    }
+    auto first = ints.begin();
+    auto last  = ints.begin();
+    TinySTL::advance(first, 10);
+    TinySTL::advance(last, 61);
+
+    long sum = 0;
+    TinySTL::for_each(ints.begin(), ints.end(), [&](int x) { sum += x; });
+    EXPECT_EQ(sum, 4950);
+    EXPECT_EQ(TinySTL::accumulate(first, last, 0), (10 + 60) * 51 / 2);
+    EXPECT_TRUE(TinySTL::find(first, last, 60) == TinySTL::find(ints.begin(), ints.end(), 60));
+    EXPECT_TRUE(TinySTL::find(first, last, 61) == last);
+    EXPECT_TRUE(TinySTL::find(ints.begin(), ints.end(), 100) == ints.end());
+
+    TinySTL::fill(first, last, -1);
+    int out[100] = {};
+    EXPECT_EQ(TinySTL::copy(ints.begin(), ints.end(), out), out + 100);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(out[i], (i >= 10 && i <= 60) ? -1 : i) << "at " << i;
+    }
+}
+
+TEST(TestUnrolledListAlign, OverAlignedElements) {
+    struct alignas(32) Wide {
+        int value;
+    };
+    struct alignas(16) Narrow {
+        int value;
+    };
+
+    // Nodes large enough for `malloc`, and small enough for the pool.
+    TinySTL::unrolled_list<Wide> wide;
+    TinySTL::unrolled_list<Narrow, TinySTL::alloc, 2> narrow;
+    for (int i = 0; i < 1000; ++i) {
+        wide.push_back(Wide{ i });
+        narrow.push_back(Narrow{ i });
+    }
+
+    int expected = 0;
+    for (auto&& w : wide) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&w) % alignof(Wide), 0u);
+        EXPECT_EQ(w.value, expected++);
+    }
+    expected = 0;
+    for (auto&& n : narrow) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&n) % alignof(Narrow), 0u);
+        EXPECT_EQ(n.value, expected++);
+    }
+
+    auto it = narrow.begin();
+    TinySTL::advance(it, 500);
+    narrow.erase(narrow.begin(), it);
+    EXPECT_EQ(narrow.size(), 500u);
+    EXPECT_EQ(narrow.front().value, 500);
+}
+
+TEST(TestUnrolledListAlign, WithArena) {
+    struct alignas(32) Wide {
+        int value;
+    };
+    TinySTL::monotonic_arena arena;
+    TinySTL::unrolled_list<Wide, TinySTL::arena_alloc, 3> wide((TinySTL::arena_alloc(arena)));
+    for (int i = 0; i < 100; ++i) {
+        wide.push_back(Wide{ i });
+    }
+    for (auto&& w : wide) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&w) % alignof(Wide), 0u);
+    }
+    wide.clear();
+    EXPECT_TRUE(wide.empty());
+}
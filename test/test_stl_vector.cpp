@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <stl_arena.hpp>
+#include <stl_vector.hpp>
+#include <cstring>
+#include <string>
+#include <vector>
+
+class TestVector : public testing::Test {
+protected:
+    TinySTL::vector<std::string> m_strings;
+    std::vector<std::string> m_expected;
+
+protected:
+    virtual void SetUp() override {
+        // Long enough to live on the heap, so that a self-moved string is emptied.
+        for (int i = 0; i < 50; ++i) {
+            m_strings.push_back("string number " + std::to_string(i) + " of the vector");
+            m_expected.push_back(m_strings.back());
+        }
+    }
+
+    void ExpectEqual() const {
+        ASSERT_EQ(m_strings.size(), m_expected.size());
+        for (size_t i = 0; i < m_expected.size(); ++i) {
+            EXPECT_EQ(m_strings[i], m_expected[i]) << "at " << i;
+        }
+    }
+};
+
+TEST_F(TestVector, EraseEmptyRange) {
+    EXPECT_EQ(m_strings.erase(m_strings.begin() + 10, m_strings.begin() + 10), m_strings.begin() + 10);
+    m_strings.erase(m_strings.begin(), m_strings.begin());
+    m_strings.erase(m_strings.end(), m_strings.end());
+    ExpectEqual();
+}
+
+TEST_F(TestVector, Erase) {
+    m_strings.erase(m_strings.begin() + 5, m_strings.begin() + 15);
+    m_expected.erase(m_expected.begin() + 5, m_expected.begin() + 15);
+    ExpectEqual();
+
+    m_strings.erase(m_strings.begin());
+    m_expected.erase(m_expected.begin());
+    m_strings.erase(m_strings.end() - 1);
+    m_expected.erase(m_expected.end() - 1);
+    ExpectEqual();
+
+    m_strings.erase(m_strings.begin(), m_strings.end());
+    EXPECT_TRUE(m_strings.empty());
+}
+
+TEST_F(TestVector, Insert) {
+    m_strings.insert(m_strings.begin() + 3, std::string("inserted"));
+    m_expected.insert(m_expected.begin() + 3, std::string("inserted"));
+    ExpectEqual();
+
+    m_strings.insert(m_strings.begin() + 20, 30, std::string("filled"));
+    m_expected.insert(m_expected.begin() + 20, 30, std::string("filled"));
+    ExpectEqual();
+
+    std::string data[] = { "a", "b", "c" };
+    m_strings.insert(m_strings.end() - 2, std::begin(data), std::end(data));
+    m_expected.insert(m_expected.end() - 2, std::begin(data), std::end(data));
+    ExpectEqual();
+
+    m_strings.insert(m_strings.begin(), std::begin(data), std::begin(data));
+    ExpectEqual();
+}
+
+TEST_F(TestVector, InsertOwnElement) {
+    m_strings.insert(m_strings.begin(), m_strings.back());
+    m_expected.insert(m_expected.begin(), m_expected.back());
+    m_strings.emplace(m_strings.begin() + 1, m_strings[10]);
+    m_expected.emplace(m_expected.begin() + 1, m_expected[10]);
+    ExpectEqual();
+}
+
+TEST_F(TestVector, Move) {
+    TinySTL::vector<std::string> moved(std::move(m_strings));
+    EXPECT_TRUE(m_strings.empty());
+    m_strings = std::move(moved);
+    ExpectEqual();
+}
+
+struct Pixel {
+    unsigned char r, g, b, a;
+};
+
+struct Counted {
+    int value = 7;
+};
+
+TEST(TestVectorDefaultInit, TrivialStructIsNotWritten) {
+    // Reused memory full of a pattern, which default initialization should leave alone.
+    static unsigned char buffer[1 << 16];
+    std::memset(buffer, 0xAB, sizeof(buffer));
+    TinySTL::monotonic_arena arena(buffer, sizeof(buffer));
+
+    TinySTL::vector<Pixel, TinySTL::arena_alloc> pixels(4096, TinySTL::default_init, TinySTL::arena_alloc(arena));
+    ASSERT_EQ(pixels.size(), 4096u);
+    size_t untouched = 0;
+    for (auto&& p : pixels) {
+        untouched += p.r == 0xAB && p.g == 0xAB && p.b == 0xAB && p.a == 0xAB;
+    }
+    EXPECT_EQ(untouched, 4096u);
+
+    Pixel* appended = pixels.append_uninitialized(16);
+    EXPECT_EQ(appended->r, 0xAB);
+    EXPECT_EQ(pixels.size(), 4112u);
+}
+
+TEST(TestVectorDefaultInit, ClassIsConstructed) {
+    TinySTL::vector<Counted> counted(100, TinySTL::default_init);
+    counted.resize_default_init(200);
+    ASSERT_EQ(counted.size(), 200u);
+    for (auto&& c : counted) {
+        EXPECT_EQ(c.value, 7);
+    }
+
+    TinySTL::vector<std::string> strings(10, TinySTL::default_init);
+    for (auto&& s : strings) {
+        EXPECT_TRUE(s.empty());
+    }
+}